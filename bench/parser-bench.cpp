@@ -0,0 +1,151 @@
+// Per byte cost of the char scanners and of the APIs built on Parser.
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Binding.hpp"
+#include "ParallelParse.hpp"
+#include "Parser.hpp"
+#include "PathQuery.hpp"
+
+using namespace std;
+using namespace xmlpp;
+
+// Tag-dense input: short names, several parameters and little text.
+string
+MakeInput(size_t aSize)
+{
+  string buffer = "<root>";
+  for (size_t i = 0; buffer.size() < aSize; ++i) {
+    buffer += "<item id='" + to_string(i) +
+              "' kind=\"entry\" flag='y'><sub a='1' b='2'/><sub/></item>\n";
+  }
+  return buffer + "</root>";
+}
+
+struct Item
+{
+  unsigned id = 0;
+  string   kind;
+};
+
+struct Items
+{
+  vector<Item> items;
+};
+
+template<>
+struct xmlpp::Binding<Item>
+{
+  static constexpr auto FIELDS = std::make_tuple(
+    AttributeField("id", &Item::id), AttributeField("kind", &Item::kind));
+};
+
+template<>
+struct xmlpp::Binding<Items>
+{
+  static constexpr auto FIELDS =
+    std::make_tuple(ChildField("item", &Items::items));
+};
+
+template<class F>
+void
+Measure(const char* aName, const string& aInput, size_t aRounds, F aScan)
+{
+  size_t sink  = 0;
+  auto   start = chrono::steady_clock::now();
+  for (size_t i = 0; i < aRounds; ++i) {
+    sink += aScan(aInput.c_str());
+  }
+  auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() -
+                                                start)
+                   .count();
+  cout << aName << ": " << elapsed / (aRounds * aInput.size())
+       << " ns/byte (" << sink << ")" << endl;
+}
+
+int
+main()
+{
+  auto   input  = MakeInput(4 << 20);
+  size_t rounds = 10;
+
+  cout << "Per byte cost on " << input.size() << " bytes of tags" << endl;
+  // What mIgnoreBlanks and the name loops used to do for every byte.
+  Measure("strchr(BLANKS)      ", input, rounds, [](const char* aCode) {
+    size_t count = 0;
+    for (; *aCode != 0; ++aCode) {
+      if (strchr(Parser::BLANKS, *aCode) || *aCode == '>' || *aCode == '/') {
+        ++count;
+      }
+    }
+    return count;
+  });
+  Measure("CHAR_CLASSES        ", input, rounds, [](const char* aCode) {
+    size_t count = 0;
+    for (; *aCode != 0; ++aCode) {
+      if (IsBlank(*aCode) || *aCode == '>' || *aCode == '/') {
+        ++count;
+      }
+    }
+    return count;
+  });
+  Measure("Parser::Next()      ", input, rounds, [](const char* aCode) {
+    size_t count = 0;
+    Parser p(aCode);
+    while (p.Next()) {
+      ++count;
+    }
+    return count;
+  });
+  Measure("Parser::Next(), tags", input, rounds, [](const char* aCode) {
+    size_t count = 0;
+    Parser p(aCode, EventMask::NONE);
+    while (p.Next()) {
+      ++count;
+    }
+    return count;
+  });
+  Measure("Parser::SkipElement()", input, rounds, [](const char* aCode) {
+    Parser p(aCode);
+    return size_t(p.SkipElement());
+  });
+  Measure("PathQuery(//item[@id='7'])", input, rounds, [](const char* aCode) {
+    size_t    count = 0;
+    PathQuery query("//item[@id='7']");
+    Parser    p(aCode, EventMask::NONE);
+    while (query.Next(p)) {
+      ++count;
+    }
+    return count;
+  });
+  Measure("Parser, generic items", input, rounds, [](const char* aCode) {
+    vector<Item> items;
+    Parser       p(aCode, EventMask::NONE);
+    while (p.Next()) {
+      if (p.Type() == EntityType::TAG && p.Value() == "item") {
+        auto& item = items.emplace_back();
+        item.id    = stoul(string(p.Parameters()["id"]));
+        item.kind  = p.Parameters()["kind"];
+      }
+    }
+    return items.size();
+  });
+  Measure("Bind<Items>()       ", input, rounds, [](const char* aCode) {
+    return Bind<Items>(aCode).items.size();
+  });
+  Measure("ParallelParse(Bind), 4 threads", input, rounds, [&](const char*) {
+    auto items = ParallelParse(
+      input.data(),
+      input.size(),
+      [](Parser& p) {
+        Item item;
+        Bind(p, item);
+        return item;
+      },
+      4);
+    return items.size();
+  });
+  return 0;
+}
@@ -1,4 +1,3 @@
-#include <fstream>
 #include <iostream>
 #include <stack>
 #include <string>
@@ -7,47 +6,61 @@
 
 using namespace std;
 
-string ReadFile(const char* aFile);
-void Eval(const string& aBuffer);
+/** @brief The tags of a formula, as ids of the NameTable in main(). */
+enum
+{
+  MATH = 1,
+  VALUE,
+  ADD,
+  MUL
+};
+
+void Eval(xmlpp::Parser& p);
 
 int
 main()
 {
-  auto buffer = ReadFile(XMLPP_DIR "/examples/math.xml");
+  xmlpp::MappedInput input(XMLPP_DIR "/examples/math.xml");
   cout << "Read buffer:" << endl;
-  cout << buffer << endl << endl;
+  cout << input.View() << endl << endl;
   cout << "Evals to: " << endl;
-  Eval(buffer);
+  xmlpp::NameTable names{"math", "value", "add", "mul"};
+  xmlpp::Parser    p(input.Data(), input.Size());
+  p.Names(&names);
+  Eval(p);
   return 0;
 }
 
 void
-Eval(const string& aBuffer)
+Eval(xmlpp::Parser& p)
 {
   using namespace xmlpp;
-  Parser p(aBuffer.c_str());
-  if (p.Type() != EntityType::TAG || p.Value() != "math") {
+  if (p.Type() != EntityType::TAG || p.NameId() != MATH) {
     throw runtime_error("Invalid formula");
   }
   stack<char>   ops;
   stack<double> vls;
   int           count = 0;
-  while (p.Next() && p.Value() != "math") {
+  while (p.Next() && p.NameId() != MATH) {
     switch (p.Type()) {
       case EntityType::COMMENT:
         break;
       case EntityType::TAG:
-        if (p.Value() == "value") {
-          ops.push('v');
-          vls.push(0);
-        } else if (p.Value() == "add") {
-          ops.push('a');
-          vls.push(0);
-        } else if (p.Value() == "mul") {
-          ops.push('m');
-          vls.push(1);
-        } else {
-          throw runtime_error("Invalid tag");
+        switch (p.NameId()) {
+          case VALUE:
+            ops.push('v');
+            vls.push(0);
+            break;
+          case ADD:
+            ops.push('a');
+            vls.push(0);
+            break;
+          case MUL:
+            ops.push('m');
+            vls.push(1);
+            break;
+          default:
+            throw runtime_error("Invalid tag");
         }
         break;
       case EntityType::TAG_ENDING: {
@@ -76,26 +89,14 @@ Eval(const string& aBuffer)
       }
       case EntityType::TEXT:
         if (ops.top() == 'v') {
-          vls.top() = stod(p.Value());
+          vls.top() = p.ValueAs<double>();
         } else {
           throw runtime_error("Values should be encolsed by <value></value>");
         }
         break;
     }
   }
-  if (p.Type() != EntityType::TAG_ENDING || p.Value() != "math") {
+  if (p.Type() != EntityType::TAG_ENDING || p.NameId() != MATH) {
     throw runtime_error("Invalid formula");
   }
 }
-
-inline string
-ReadFile(const char* aFile)
-{
-  string   buffer;
-  ifstream input(aFile);
-  string   line;
-  while (getline(input, line)) {
-    buffer += line + '\n';
-  }
-  return buffer;
-}
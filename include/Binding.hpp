@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Parser.hpp"
+
+namespace xmlpp {
+
+/**
+ * @brief Describes how the fields of T are read, by specialization.
+ *
+ * A specialization holds a constexpr tuple of AttributeField() and
+ * ChildField() entries:
+ *
+ * @code
+ * struct Point { int x; double y; std::string label; };
+ *
+ * template<>
+ * struct xmlpp::Binding<Point>
+ * {
+ *   static constexpr auto FIELDS =
+ *     std::make_tuple(AttributeField("x", &Point::x),
+ *                     ChildField("y", &Point::y),
+ *                     ChildField("label", &Point::label));
+ * };
+ *
+ * auto point = Bind<Point>("<point x='1'><y>2.5</y></point>");
+ * @endcode
+ *
+ * Fields can be arithmetic, converted with ParseValue(), std::string,
+ * other bound structs, or a std::vector of those for repeated children.
+ *
+ * The field names are hashed into a table sorted at compile time. A name
+ * read is looked up there by its hash, and only compared to the names of
+ * the fields sharing that hash.
+ */
+template<typename T>
+struct Binding;
+
+namespace binding {
+
+enum class FieldKind
+{
+  ATTRIBUTE,
+  CHILD,
+};
+
+/**
+ * @brief The FNV-1a hash of a name, used to look fields up by name.
+ */
+constexpr uint32_t
+NameHash(std::string_view aName)
+{
+  uint32_t hash = 2166136261u;
+  for (char c : aName) {
+    hash = (hash ^ uint8_t(c)) * 16777619u;
+  }
+  return hash;
+}
+
+template<typename Class, typename Member, FieldKind KIND>
+struct Field
+{
+  static constexpr FieldKind FIELD_KIND = KIND;
+
+  std::string_view mName;
+  uint32_t         mHash;
+  Member Class::*mMember;
+};
+
+template<typename T, typename = void>
+struct IsBound : std::false_type
+{
+};
+
+template<typename T>
+struct IsBound<T, std::void_t<decltype(Binding<T>::FIELDS)>> : std::true_type
+{
+};
+
+template<typename T>
+struct IsVector : std::false_type
+{
+};
+
+template<typename T>
+struct IsVector<std::vector<T>> : std::true_type
+{
+};
+}
+
+template<typename Class, typename Member>
+constexpr binding::Field<Class, Member, binding::FieldKind::ATTRIBUTE>
+AttributeField(std::string_view aName, Member Class::*aMember)
+{
+  return {aName, binding::NameHash(aName), aMember};
+}
+
+template<typename Class, typename Member>
+constexpr binding::Field<Class, Member, binding::FieldKind::CHILD>
+ChildField(std::string_view aName, Member Class::*aMember)
+{
+  return {aName, binding::NameHash(aName), aMember};
+}
+
+/**
+ * @brief Reads the tag aParser is at into aOut, through Binding<T>.
+ *
+ * Parameters and children without a field are ignored, the latter skipped
+ * with Parser::SkipElement(). Fields without a parameter or child are left
+ * untouched. The parser is left at the tag's ending.
+ * @throw ParserError if a value can not be converted, or if the document is
+ * invalid or ends before the tag does.
+ */
+template<typename T>
+void
+Bind(Parser& aParser, T& aOut);
+
+/**
+ * @brief Reads a document, whose first tag is bound to T.
+ * @throw ParserError if the document is invalid or has no tag.
+ */
+template<typename T>
+T
+Bind(std::string_view aCode);
+
+namespace binding {
+
+template<typename V>
+void
+ConvertValue(std::string_view aName, std::string_view aText, V& aOut)
+{
+  if constexpr (std::is_same_v<V, std::string>) {
+    aOut.assign(aText);
+  } else {
+    try {
+      aOut = ParseValue<V>(aText);
+    } catch (const ParserError& e) {
+      throw ParserError(std::string(aName) + ": " + e.what());
+    }
+  }
+}
+
+// Reads the texts of a leaf child, up to its ending.
+template<typename V>
+void
+BindText(Parser& aParser, std::string_view aName, V& aOut)
+{
+  bool first = true;
+  for (;;) {
+    if (!aParser.Next()) {
+      throw ParserError("Unexpected end of the document in " +
+                        std::string(aName));
+    }
+    auto type = aParser.Type();
+    if (type == EntityType::TAG_ENDING) {
+      break;
+    }
+    if (type == EntityType::TAG) {
+      aParser.SkipElement();
+    } else if (type == EntityType::TEXT) {
+      auto text = aParser.ValueView();
+      if (first) {
+        ConvertValue(aName, text, aOut);
+        first = false;
+      } else if constexpr (std::is_same_v<V, std::string>) {
+        aOut.append(text);
+      } else if (text.find_first_not_of(Parser::BLANKS) != text.npos) {
+        throw ParserError("Invalid value for " + std::string(aName) +
+                          ": split by tags or comments");
+      }
+    }
+  }
+  if (first) {
+    ConvertValue(aName, std::string_view(), aOut);
+  }
+}
+
+template<typename V>
+void
+BindChild(Parser& aParser, std::string_view aName, V& aOut)
+{
+  if constexpr (IsBound<V>::value) {
+    Bind(aParser, aOut);
+  } else if constexpr (IsVector<V>::value) {
+    BindChild(aParser, aName, aOut.emplace_back());
+  } else {
+    BindText(aParser, aName, aOut);
+  }
+}
+
+// A field's name hash, with the field's index in FIELDS.
+struct HashEntry
+{
+  uint32_t mHash;
+  uint32_t mIndex;
+};
+
+// The entries of the fields of one kind, sorted by hash.
+template<FieldKind KIND, typename Fields, size_t... I>
+constexpr auto
+SortedHashes(const Fields& aFields, std::index_sequence<I...>)
+{
+  constexpr size_t COUNT =
+    ((std::tuple_element_t<I, Fields>::FIELD_KIND == KIND) + ... + 0);
+  std::array<HashEntry, COUNT> table{};
+  size_t                       size = 0;
+  // An insertion sort, as std::sort is not constexpr in C++17.
+  auto add = [&](uint32_t aHash, uint32_t aIndex) {
+    size_t k = size++;
+    for (; k > 0 && table[k - 1].mHash > aHash; --k) {
+      table[k] = table[k - 1];
+    }
+    table[k] = {aHash, aIndex};
+  };
+  ((std::tuple_element_t<I, Fields>::FIELD_KIND == KIND
+      ? add(std::get<I>(aFields).mHash, uint32_t(I))
+      : void()),
+   ...);
+  return table;
+}
+
+// Calls aVisit on the field at aIndex, which compiles to a switch.
+template<typename Fields, typename Visit, size_t... I>
+bool
+VisitField(const Fields& aFields,
+           size_t        aIndex,
+           Visit&        aVisit,
+           std::index_sequence<I...>)
+{
+  bool bound = false;
+  ((I == aIndex && (bound = aVisit(std::get<I>(aFields)), true)) || ...);
+  return bound;
+}
+
+// Hands the named parameter or child to its field, if there is one.
+template<FieldKind KIND, typename T>
+bool
+Dispatch(Parser&          aParser,
+         std::string_view aName,
+         std::string_view aValue,
+         T&               aOut)
+{
+  constexpr auto& fields = Binding<T>::FIELDS;
+  using Fields           = std::decay_t<decltype(fields)>;
+  using Indices = std::make_index_sequence<std::tuple_size_v<Fields>>;
+  static constexpr auto TABLE = SortedHashes<KIND>(fields, Indices{});
+
+  auto visit = [&](auto& aField) {
+    if constexpr (std::decay_t<decltype(aField)>::FIELD_KIND != KIND) {
+      return false;
+    } else {
+      if (aField.mName != aName) {
+        return false;
+      }
+      if constexpr (KIND == FieldKind::ATTRIBUTE) {
+        ConvertValue(aField.mName, aValue, aOut.*aField.mMember);
+      } else {
+        BindChild(aParser, aField.mName, aOut.*aField.mMember);
+      }
+      return true;
+    }
+  };
+  auto hash  = NameHash(aName);
+  auto below = [](const HashEntry& aEntry, uint32_t aHash) {
+    return aEntry.mHash < aHash;
+  };
+  auto entry = std::lower_bound(TABLE.begin(), TABLE.end(), hash, below);
+  // Names are only compared among the fields sharing the hash.
+  for (; entry != TABLE.end() && entry->mHash == hash; ++entry) {
+    if (VisitField(fields, entry->mIndex, visit, Indices{})) {
+      return true;
+    }
+  }
+  return false;
+}
+}
+
+template<typename T>
+void
+Bind(Parser& aParser, T& aOut)
+{
+  static_assert(binding::IsBound<T>::value, "Binding<T> is not specialized");
+  using binding::FieldKind;
+  assert(aParser.Type() == EntityType::TAG);
+  for (auto& param : aParser.Parameters()) {
+    binding::Dispatch<FieldKind::ATTRIBUTE>(
+      aParser, param.first, param.second, aOut);
+  }
+  for (;;) {
+    if (!aParser.Next()) {
+      throw ParserError("Unexpected end of the document in a bound tag");
+    }
+    auto type = aParser.Type();
+    if (type == EntityType::TAG_ENDING) {
+      return;
+    }
+    if (type == EntityType::TAG &&
+        !binding::Dispatch<FieldKind::CHILD>(
+          aParser, aParser.ValueView(), {}, aOut)) {
+      aParser.SkipElement();
+    }
+  }
+}
+
+template<typename T>
+T
+Bind(std::string_view aCode)
+{
+  T      result{};
+  Parser parser(aCode.data(), aCode.size(), EventMask::TEXTS);
+  do {
+    if (parser.Type() == EntityType::TAG) {
+      Bind(parser, result);
+      return result;
+    }
+  } while (parser.Next());
+  throw ParserError("No tag to bind in the document");
+}
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "Parser.hpp"
+
+namespace xmlpp {
+
+class Node;
+
+/**
+ * @brief The children of a node, as a forward range.
+ */
+class NodeRange
+{
+public:
+  class iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = Node;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const Node*;
+    using reference         = const Node&;
+
+    explicit iterator(const Node* aNode = nullptr)
+      : mNode(aNode)
+    {
+    }
+
+    reference operator*() const { return *mNode; }
+    pointer   operator->() const { return mNode; }
+    iterator& operator++();
+    iterator  operator++(int)
+    {
+      auto temp = *this;
+      ++*this;
+      return temp;
+    }
+    bool operator==(const iterator& aOther) const
+    {
+      return mNode == aOther.mNode;
+    }
+    bool operator!=(const iterator& aOther) const
+    {
+      return mNode != aOther.mNode;
+    }
+
+  private:
+    const Node* mNode;
+  };
+
+  explicit NodeRange(const Node* aFirst)
+    : mFirst(aFirst)
+  {
+  }
+
+  iterator begin() const { return iterator(mFirst); }
+  iterator end() const { return iterator(); }
+  bool     empty() const { return mFirst == nullptr; }
+
+private:
+  const Node* mFirst;
+};
+
+/**
+ * @brief A tag, text or comment of a Document.
+ *
+ * Nodes are stored in document order, so links are kept as distances
+ * between nodes: the first child of a node is right after it, and its next
+ * sibling is right after its subtree.
+ */
+class Node
+{
+public:
+  using Param = ParamsMap::value_type;
+
+  /**
+   * @brief The parameters of a tag, in document order.
+   */
+  class ParamRange
+  {
+  public:
+    const Param* begin() const { return mBegin; }
+    const Param* end() const { return mEnd; }
+    size_t       size() const { return mEnd - mBegin; }
+    bool         empty() const { return mBegin == mEnd; }
+
+  private:
+    friend class Node;
+
+    const Param* mBegin;
+    const Param* mEnd;
+  };
+
+  /**
+   * @brief TAG, TEXT or COMMENT. Tag endings have no nodes of their own.
+   */
+  EntityType Type() const { return mType; }
+
+  /**
+   * @brief The tag name, or an empty view for texts and comments.
+   */
+  std::string_view Name() const
+  {
+    return mType == EntityType::TAG ? mValue : std::string_view();
+  }
+
+  /**
+   * @brief The value, with the same meaning as Parser::Value().
+   */
+  std::string_view Value() const { return mValue; }
+
+  ParamRange Parameters() const
+  {
+    ParamRange range;
+    range.mBegin = mParameters;
+    range.mEnd   = mParameters + mParameterCount;
+    return range;
+  }
+
+  /**
+   * @brief Returns the value of the given parameter, or an empty view.
+   */
+  std::string_view Parameter(std::string_view aName) const;
+
+  const Node* Parent() const { return mParent ? this - mParent : nullptr; }
+  const Node* FirstChild() const { return mSubtree > 1 ? this + 1 : nullptr; }
+  const Node* NextSibling() const { return mNext ? this + mNext : nullptr; }
+
+  NodeRange Children() const { return NodeRange(FirstChild()); }
+
+  /**
+   * @brief How many nodes the subtree has, counting this one.
+   */
+  size_t SubtreeSize() const { return mSubtree; }
+
+private:
+  friend class Document;
+
+  EntityType       mType           = EntityType::TEXT;
+  uint32_t         mParent         = 0;
+  uint32_t         mNext           = 0;
+  uint32_t         mSubtree        = 1;
+  uint32_t         mParameterCount = 0;
+  const Param*     mParameters     = nullptr;
+  std::string_view mValue;
+};
+
+inline NodeRange::iterator&
+NodeRange::iterator::operator++()
+{
+  mNode = mNode->NextSibling();
+  return *this;
+}
+
+/**
+ * @brief A whole document as a tree of nodes, built from Parser events.
+ *
+ * Every node, parameter and decoded string comes from a single monotonic
+ * arena, released at once with the document. Nodes are contiguous and in
+ * document order. Names and values without escapes are views into the
+ * source, which must outlive the document.
+ */
+class Document
+{
+public:
+  /**
+   * @brief Parses aSize chars from aData.
+   * @throw ParserError if the document is invalid.
+   */
+  Document(const char* aData, size_t aSize);
+
+  /**
+   * @brief Parses a c-string.
+   */
+  explicit Document(const char* aCode)
+    : Document(aCode, strlen(aCode))
+  {
+  }
+
+  Document(Document&&) = default;
+
+  // The nodes would be copied into the arena being released.
+  Document& operator=(Document&&) = delete;
+
+  /**
+   * @brief The first top level tag, or nullptr if there is none.
+   */
+  const Node* Root() const;
+
+  /**
+   * @brief The top level nodes.
+   */
+  NodeRange Children() const
+  {
+    return NodeRange(mNodes.empty() ? nullptr : mNodes.data());
+  }
+
+  /**
+   * @brief All nodes, in document order.
+   */
+  const Node* begin() const { return mNodes.data(); }
+  const Node* end() const { return mNodes.data() + mNodes.size(); }
+  size_t      size() const { return mNodes.size(); }
+
+private:
+  // Sizes are only guessed from the input, which may be a single text, so
+  // the first reservations are capped and grow on demand from there.
+  static constexpr size_t MAX_INITIAL_ARENA = size_t(1) << 20;
+  static constexpr size_t MAX_INITIAL_NODES = size_t(1) << 12;
+
+  // The arena lives on the heap, so the document can be moved.
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> mArena;
+  std::pmr::vector<Node>                               mNodes;
+  const char*                                          mSource;
+  size_t                                               mSize;
+
+  std::string_view mKeep(std::string_view aText);
+};
+
+inline std::string_view
+Node::Parameter(std::string_view aName) const
+{
+  for (auto& param : Parameters()) {
+    if (param.first == aName) {
+      return param.second;
+    }
+  }
+  return {};
+}
+
+inline Document::Document(const char* aData, size_t aSize)
+  : mArena(std::make_unique<std::pmr::monotonic_buffer_resource>(
+      std::min(aSize / 2, MAX_INITIAL_ARENA) + 256))
+  , mNodes(mArena.get())
+  , mSource(aData)
+  , mSize(aSize)
+{
+  constexpr uint32_t NONE = UINT32_MAX;
+  mNodes.reserve(std::min(aSize / 32, MAX_INITIAL_NODES));
+  std::vector<uint32_t> open;
+  // The last child seen on each open level, the top one included.
+  std::vector<uint32_t> last = {NONE};
+  Parser                parser(aData, aSize);
+  do {
+    auto type = parser.Type();
+    if (type == EntityType::TAG_ENDING) {
+      auto tag = open.back();
+      open.pop_back();
+      last.pop_back();
+      mNodes[tag].mSubtree = uint32_t(mNodes.size() - tag);
+      continue;
+    }
+    if (type == EntityType::TEXT && parser.ValueView().empty()) {
+      continue;
+    }
+    auto  index = uint32_t(mNodes.size());
+    auto& node  = mNodes.emplace_back();
+    node.mType  = type;
+    node.mValue = mKeep(parser.ValueView());
+    if (!open.empty()) {
+      node.mParent = index - open.back();
+    }
+    if (last.back() != NONE) {
+      mNodes[last.back()].mNext = index - last.back();
+    }
+    last.back() = index;
+    if (type == EntityType::TAG) {
+      auto& params = parser.Parameters();
+      if (!params.empty()) {
+        std::pmr::polymorphic_allocator<Node::Param> allocator(mArena.get());
+        auto parameters = allocator.allocate(params.size());
+        for (size_t i = 0; i < params.size(); ++i) {
+          auto& param = params.begin()[i];
+          new (parameters + i)
+            Node::Param(mKeep(param.first), mKeep(param.second));
+        }
+        node.mParameters     = parameters;
+        node.mParameterCount = uint32_t(params.size());
+      }
+      open.push_back(index);
+      last.push_back(NONE);
+    }
+  } while (parser.Next());
+  if (!open.empty()) {
+    throw ParserError("Unclosed tag at the end of the document");
+  }
+}
+
+inline const Node*
+Document::Root() const
+{
+  for (auto& node : Children()) {
+    if (node.Type() == EntityType::TAG) {
+      return &node;
+    }
+  }
+  return nullptr;
+}
+
+inline std::string_view
+Document::mKeep(std::string_view aText)
+{
+  auto data = aText.data();
+  if (aText.empty() ||
+      (data >= mSource && data + aText.size() <= mSource + mSize)) {
+    return aText;
+  }
+  auto copy = static_cast<char*>(mArena->allocate(aText.size(), 1));
+  memcpy(copy, aText.data(), aText.size());
+  return std::string_view(copy, aText.size());
+}
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <string_view>
+#include <utility>
+#include "Parser.hpp"
+
+namespace xmlpp {
+
+/**
+ * @brief An asynchronous stream of parser events, produced by a coroutine.
+ *
+ * The producer coroutine co_yields a Parser for each event, and the consumer
+ * awaits them one at a time from its own coroutine:
+ *
+ * @code
+ * auto events = ParseEvents([&] { return socket.AsyncRead(); });
+ * while (co_await events.Next()) {
+ *   auto& p = events.Current();
+ *   ...
+ * }
+ * @endcode
+ *
+ * Control goes straight from one coroutine to the other, so no thread blocks
+ * while a stream waits for input and a single thread can drive many streams.
+ */
+class EventStream
+{
+public:
+  struct promise_type;
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  EventStream(EventStream&& aOther) noexcept
+    : mHandle(std::exchange(aOther.mHandle, nullptr))
+  {
+  }
+
+  EventStream& operator=(EventStream&& aOther) noexcept
+  {
+    std::swap(mHandle, aOther.mHandle);
+    return *this;
+  }
+
+  ~EventStream()
+  {
+    if (mHandle) {
+      mHandle.destroy();
+    }
+  }
+
+  /**
+   * @brief Awaits the next event.
+   *
+   * The awaited value is true if there is an event, or false if the stream
+   * ended. Errors of the producer, like ParserError, are rethrown there.
+   */
+  auto Next();
+
+  /**
+   * @brief The parser at the current event.
+   *
+   * The reference is valid until Next() is awaited again.
+   */
+  const Parser& Current() const { return *mHandle.promise().mCurrent; }
+
+private:
+  Handle mHandle;
+
+  explicit EventStream(Handle aHandle)
+    : mHandle(aHandle)
+  {
+  }
+
+  // Hands control back to whoever awaits Next().
+  struct ResumeConsumer
+  {
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(Handle aProducer) noexcept
+    {
+      return aProducer.promise().mConsumer;
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+public:
+  struct promise_type
+  {
+    const Parser*           mCurrent = nullptr;
+    std::coroutine_handle<> mConsumer;
+    std::exception_ptr      mError;
+
+    EventStream get_return_object()
+    {
+      return EventStream(Handle::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    ResumeConsumer final_suspend() const noexcept { return {}; }
+
+    ResumeConsumer yield_value(const Parser& aParser) noexcept
+    {
+      mCurrent = &aParser;
+      return {};
+    }
+
+    void return_void() noexcept { mCurrent = nullptr; }
+
+    void unhandled_exception() noexcept
+    {
+      mCurrent = nullptr;
+      mError   = std::current_exception();
+    }
+  };
+};
+
+inline auto
+EventStream::Next()
+{
+  struct Awaiter
+  {
+    Handle mProducer;
+
+    bool await_ready() const noexcept { return mProducer.done(); }
+
+    std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<> aConsumer) noexcept
+    {
+      mProducer.promise().mConsumer = aConsumer;
+      return mProducer;
+    }
+
+    bool await_resume() const
+    {
+      auto& promise = mProducer.promise();
+      if (promise.mError) {
+        std::rethrow_exception(std::exchange(promise.mError, nullptr));
+      }
+      return promise.mCurrent != nullptr;
+    }
+  };
+  return Awaiter{mHandle};
+}
+
+/**
+ * @brief Parses the input read by aRead, as an EventStream.
+ *
+ * aRead is called whenever the parser runs out of input, and must return an
+ * awaitable whose result converts to std::string_view: the next chunk, or
+ * an empty one once the input ended. A chunk only needs to stay valid until
+ * aRead is called again.
+ *
+ * It is built on the push mode of Parser, so events come out as soon as
+ * they are complete.
+ */
+template<typename Read>
+EventStream
+ParseEvents(Read aRead)
+{
+  Parser parser;
+  for (;;) {
+    while (parser.Next()) {
+      co_yield parser;
+    }
+    if (!parser.NeedsInput()) {
+      co_return;
+    }
+    std::string_view chunk = co_await aRead();
+    if (chunk.empty()) {
+      parser.Finish();
+    } else {
+      parser.Feed(chunk.data(), chunk.size());
+    }
+  }
+}
+}
+
+#endif
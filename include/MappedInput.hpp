@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define XMLPP_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace xmlpp {
+
+/**
+ * @brief A read only file mapped in memory, to be parsed in place.
+ *
+ * The file is mapped with sequential access advice and is never copied.
+ * Its content is not NUL terminated, so parse it with
+ * Parser(Data(), Size()) or Parser::FromFile().
+ *
+ * On systems without mmap the file is read into memory instead.
+ */
+class MappedInput
+{
+public:
+  /**
+   * @brief Maps the given file.
+   * @throw std::system_error if the file can not be opened or mapped.
+   */
+  explicit MappedInput(const char* aPath);
+
+  MappedInput(const MappedInput&) = delete;
+  MappedInput& operator=(const MappedInput&) = delete;
+
+  ~MappedInput();
+
+  /**
+   * @brief The file content, Size() chars long.
+   */
+  const char* Data() const { return mData; }
+
+  /**
+   * @brief The file size.
+   */
+  size_t Size() const { return mSize; }
+
+  std::string_view View() const { return {mData, mSize}; }
+
+private:
+  const char* mData = "";
+  size_t      mSize = 0;
+#ifdef XMLPP_MMAP
+  void* mMapping = nullptr;
+#else
+  std::string mContent;
+#endif
+};
+
+#ifdef XMLPP_MMAP
+inline MappedInput::MappedInput(const char* aPath)
+{
+  // The error is taken before close() or munmap() can change errno.
+  auto fail = [aPath](int aError, const char* aWhat) {
+    throw std::system_error(
+      aError, std::generic_category(), aWhat + std::string(aPath));
+  };
+  int fd = open(aPath, O_RDONLY);
+  if (fd < 0) {
+    fail(errno, "Can not open ");
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    int error = errno;
+    close(fd);
+    fail(error, "Can not stat ");
+  }
+  mSize = size_t(info.st_size);
+  if (mSize == 0) {
+    close(fd);
+    return;
+  }
+  mMapping  = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  int error = errno;
+  close(fd);
+  if (mMapping == MAP_FAILED) {
+    mMapping = nullptr;
+    fail(error, "Can not map ");
+  }
+  madvise(mMapping, mSize, MADV_SEQUENTIAL);
+  mData = static_cast<const char*>(mMapping);
+}
+
+inline MappedInput::~MappedInput()
+{
+  if (mMapping) {
+    munmap(mMapping, mSize);
+  }
+}
+#else
+inline MappedInput::MappedInput(const char* aPath)
+{
+  std::ifstream input(aPath, std::ios::binary);
+  if (!input) {
+    throw std::system_error(
+      errno, std::generic_category(), "Can not open " + std::string(aPath));
+  }
+  std::ostringstream content;
+  content << input.rdbuf();
+  mContent = content.str();
+  mData    = mContent.c_str();
+  mSize    = mContent.size();
+}
+
+inline MappedInput::~MappedInput() = default;
+#endif
+}
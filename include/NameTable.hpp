@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace xmlpp {
+
+/**
+ * @brief Interns tag and parameter names as small integer ids.
+ *
+ * Ids are given in registration order, starting at 1, and stay stable for
+ * the table's lifetime. Pre-registering names in a known order lets callers
+ * switch on the ids instead of comparing strings:
+ *
+ * @code
+ * enum { MATH = 1, VALUE, ADD };
+ * NameTable names{"math", "value", "add"};
+ * Parser    p(code);
+ * p.Names(&names);
+ * switch (p.NameId()) { case VALUE: ... }
+ * @endcode
+ */
+class NameTable
+{
+public:
+  using Id = uint32_t;
+
+  /// @brief Id of no name, never returned by Register().
+  static constexpr Id NO_ID = 0;
+
+  NameTable() = default;
+
+  /**
+   * @brief Registers the given names, with ids from 1 on in this order.
+   */
+  NameTable(std::initializer_list<std::string_view> aNames);
+
+  // The index points to mNames, so copying would need to rebuild it.
+  NameTable(const NameTable&) = delete;
+  NameTable& operator=(const NameTable&) = delete;
+
+  /**
+   * @brief Returns the id of aName, registering it if needed.
+   */
+  Id Register(std::string_view aName);
+
+  /**
+   * @brief Returns the id of aName, or NO_ID if not registered.
+   */
+  Id Find(std::string_view aName) const;
+
+  /**
+   * @brief Returns the name with the given id.
+   */
+  std::string_view Name(Id aId) const { return mNames.at(aId - 1); }
+
+  /**
+   * @brief Returns how many names were registered.
+   */
+  size_t size() const { return mNames.size(); }
+
+private:
+  // A deque never moves its elements, so the index keys stay valid.
+  std::deque<std::string>                  mNames;
+  std::unordered_map<std::string_view, Id> mIndex;
+};
+
+inline NameTable::NameTable(std::initializer_list<std::string_view> aNames)
+{
+  for (auto name : aNames) {
+    Register(name);
+  }
+}
+
+inline NameTable::Id
+NameTable::Register(std::string_view aName)
+{
+  auto it = mIndex.find(aName);
+  if (it != mIndex.end()) {
+    return it->second;
+  }
+  mNames.emplace_back(aName);
+  Id id = Id(mNames.size());
+  mIndex.emplace(mNames.back(), id);
+  return id;
+}
+
+inline NameTable::Id
+NameTable::Find(std::string_view aName) const
+{
+  auto it = mIndex.find(aName);
+  return it == mIndex.end() ? NO_ID : it->second;
+}
+}
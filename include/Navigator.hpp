@@ -0,0 +1,195 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include "Parser.hpp"
+
+namespace xmlpp {
+
+/**
+ * @brief A forward only cursor over the elements of a document.
+ *
+ * Each step reads only as far as it needs, skipping the siblings it passes
+ * with Parser::SkipElement(), so reading a few values near the top of a
+ * large document parses little of it:
+ *
+ * @code
+ * Navigator nav(code);
+ * auto id = nav.Child("root").Child("head").Attr("id");
+ * for (nav.Next("item"); nav; nav.Next("item")) { ... }
+ * @endcode
+ *
+ * Once a step fails to find its element the navigator stays invalid, and
+ * every further step does nothing.
+ */
+class Navigator
+{
+public:
+  // Comments are never looked at, so they are not reported at all.
+  explicit Navigator(const char* aCode)
+    : mParser(aCode, EventMask::TEXTS)
+  {
+  }
+
+  Navigator(const char* aData, size_t aSize)
+    : mParser(aData, aSize, EventMask::TEXTS)
+  {
+  }
+
+  /**
+   * @brief Navigates the entities of the given parser, from its current one.
+   */
+  explicit Navigator(Parser aParser)
+    : mParser(std::move(aParser))
+  {
+  }
+
+  /**
+   * @brief Moves to the first child tag of the current element named aName.
+   *
+   * At the start the current element is the document itself.
+   */
+  Navigator& Child(std::string_view aName);
+
+  /**
+   * @brief Moves to the next sibling tag named aName.
+   */
+  Navigator& Next(std::string_view aName);
+
+  /**
+   * @brief Returns the given parameter of the current element.
+   *
+   * It is empty if missing. The view is valid until the next step, and
+   * parameters can only be read before Text().
+   */
+  std::string_view Attr(std::string_view aName) const;
+
+  /**
+   * @brief Returns the texts directly inside the current element.
+   *
+   * It reads up to the element's end, so its children can not be visited
+   * afterwards.
+   */
+  std::string Text();
+
+  /**
+   * @brief Returns true if the last step found its element.
+   */
+  explicit operator bool() const { return mValid; }
+
+  /**
+   * @brief The underlying parser, at the current element when valid.
+   */
+  const Parser& GetParser() const { return mParser; }
+
+private:
+  Parser mParser;
+  bool   mValid = true;
+  // The parser is at the current element's ending, not at its tag.
+  bool mClosed = false;
+  // The parser's entity was not looked at yet.
+  bool mPending = true;
+  // Depth of the current element's children.
+  size_t mChildDepth = 0;
+
+  bool mAdvance();
+
+  bool mFind(std::string_view aName, size_t aDepth);
+
+  void mSkip();
+};
+
+inline Navigator&
+Navigator::Child(std::string_view aName)
+{
+  if (mValid && !mClosed) {
+    mValid = mFind(aName, mChildDepth);
+  } else {
+    mValid = false;
+  }
+  return *this;
+}
+
+inline Navigator&
+Navigator::Next(std::string_view aName)
+{
+  if (!mValid || mChildDepth == 0) {
+    mValid = false;
+    return *this;
+  }
+  if (!mClosed) {
+    mSkip();
+  }
+  mValid = mFind(aName, mChildDepth - 1);
+  return *this;
+}
+
+inline std::string_view
+Navigator::Attr(std::string_view aName) const
+{
+  if (!mValid || mClosed) {
+    return {};
+  }
+  return mParser.Parameters()[aName];
+}
+
+inline std::string
+Navigator::Text()
+{
+  std::string text;
+  if (!mValid || mClosed) {
+    return text;
+  }
+  while (mAdvance()) {
+    auto type = mParser.Type();
+    if (type == EntityType::TAG) {
+      mSkip();
+    } else if (type == EntityType::TAG_ENDING) {
+      break;
+    } else if (type == EntityType::TEXT) {
+      text += mParser.ValueView();
+    }
+  }
+  mClosed = true;
+  return text;
+}
+
+inline bool
+Navigator::mAdvance()
+{
+  if (mPending) {
+    mPending = false;
+    return true;
+  }
+  return mParser.Next();
+}
+
+inline bool
+Navigator::mFind(std::string_view aName, size_t aDepth)
+{
+  while (mAdvance()) {
+    auto type = mParser.Type();
+    if (type == EntityType::TAG_ENDING && mParser.Depth() < aDepth) {
+      // The parent ended, so it stays closed for further steps.
+      mClosed = true;
+      return false;
+    }
+    if (type == EntityType::TAG) {
+      if (mParser.ValueView() == aName) {
+        mChildDepth = mParser.Depth() + 1;
+        mClosed     = false;
+        return true;
+      }
+      mSkip();
+    }
+  }
+  return false;
+}
+
+inline void
+Navigator::mSkip()
+{
+  mParser.SkipElement();
+}
+}
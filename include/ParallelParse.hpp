@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Parser.hpp"
+
+namespace xmlpp {
+
+/**
+ * @brief Reads the children of a document's root on several threads.
+ *
+ * aRead is called with a Parser at each child tag of the root, and its
+ * results are returned in document order. It may read the child, and
+ * leave the parser anywhere up to the child's ending. Each thread has its
+ * own copy of aRead, so it should only compute its result: a child can be
+ * read again when a chunk is parsed twice.
+ *
+ * The children are split in chunks at tags named like the first child,
+ * which are parsed on up to aThreads threads (all cores by default), with
+ * no chunk smaller than aMinChunk bytes. A chunk starts with an empty tag
+ * stack, and is only kept if it starts where the previous one really
+ * ended. Otherwise it was not split at a child of the root, and is parsed
+ * again from there. If a kept chunk fails, the rest of the document is read
+ * again on this thread, so errors do not depend on the thread count.
+ * @throw ParserError if the document is invalid or has a second root.
+ */
+template<typename Read>
+auto
+ParallelParse(const char* aData,
+              size_t      aSize,
+              Read        aRead,
+              size_t      aThreads  = 0,
+              size_t      aMinChunk = size_t(1) << 20)
+  -> std::vector<std::invoke_result_t<Read&, Parser&>>;
+
+namespace parallel {
+
+// A document has a single root, so a tag after it is an error.
+inline ParserError
+SecondRootError(const Parser& aParser)
+{
+  return ParserError("Unexpected second root tag: " +
+                     std::string(aParser.RawValue()));
+}
+
+// Moves from a child tag, or from where its reader left, to its ending.
+inline void
+FinishChild(Parser& aParser, size_t aDepth)
+{
+  if (aParser.Type() == EntityType::TAG && aParser.Depth() == aDepth) {
+    aParser.SkipElement();
+  }
+  while (aParser.Type() != EntityType::TAG_ENDING ||
+         aParser.Depth() != aDepth) {
+    if (!aParser.Next()) {
+      throw ParserError("Unclosed tag at the end of the document");
+    }
+  }
+}
+
+/*
+ * Reads the tags at aDepth, until one starts at or after aLimit. Returns
+ * where that one starts, or nullptr if the input ended first.
+ */
+template<typename Read, typename Result>
+const char*
+ReadChildren(Parser&              aParser,
+             size_t               aDepth,
+             const char*          aLimit,
+             Read&                aRead,
+             std::vector<Result>& aResults)
+{
+  do {
+    if (aParser.Type() == EntityType::TAG && aParser.Depth() < aDepth) {
+      throw SecondRootError(aParser);
+    }
+    if (aParser.Type() != EntityType::TAG || aParser.Depth() != aDepth) {
+      continue;
+    }
+    auto begin = aParser.RawValue().data() - 1;
+    if (begin >= aLimit) {
+      return begin;
+    }
+    aResults.push_back(aRead(aParser));
+    FinishChild(aParser, aDepth);
+  } while (aParser.Next());
+  return nullptr;
+}
+
+// Where the next tag starting with aOpening, like "<item", opens, or aEnd.
+inline const char*
+FindTag(const char* aBegin, const char* aEnd, std::string_view aOpening)
+{
+  std::string_view rest(aBegin, aEnd - aBegin);
+  for (size_t found = rest.find(aOpening); found != rest.npos;
+       found        = rest.find(aOpening, found + 1)) {
+    auto next = found + aOpening.size();
+    if (next < rest.size() &&
+        (IsBlank(rest[next]) || rest[next] == '/' || rest[next] == '>')) {
+      return aBegin + found;
+    }
+  }
+  return aEnd;
+}
+
+// Where the root's closing tag starts, or nullptr if unsure.
+inline const char*
+FindRootEnd(const char* aData, size_t aSize, std::string_view aRoot)
+{
+  std::string_view code(aData, aSize);
+  auto             found = code.rfind("</");
+  if (found == code.npos || code.substr(found + 2, aRoot.size()) != aRoot) {
+    return nullptr;
+  }
+  auto after =
+    code.find_first_not_of(Parser::BLANKS, found + 2 + aRoot.size());
+  if (after == code.npos || code[after] != '>') {
+    return nullptr;
+  }
+  // A '>' after it may end a comment holding it, so it is not trusted.
+  auto rest = code.substr(after + 1);
+  if (rest.find('>') != rest.npos) {
+    return nullptr;
+  }
+  // Whatever follows the root must still be valid.
+  Parser tail(rest.data(), rest.size());
+  while (tail.Next()) {
+  }
+  return aData + found;
+}
+}
+
+template<typename Read>
+auto
+ParallelParse(const char* aData,
+              size_t      aSize,
+              Read        aRead,
+              size_t      aThreads,
+              size_t      aMinChunk)
+  -> std::vector<std::invoke_result_t<Read&, Parser&>>
+{
+  using Result = std::invoke_result_t<Read&, Parser&>;
+  using namespace parallel;
+  static_assert(!std::is_void_v<Result>, "The reader must return a result");
+
+  std::vector<Result> results;
+  Parser              head(aData, aSize);
+  std::string_view    root;
+  do {
+    if (head.Type() == EntityType::TAG && head.Depth() == 0) {
+      if (!root.empty()) {
+        throw SecondRootError(head);
+      }
+      root = head.RawValue();
+    } else if (head.Type() == EntityType::TAG && head.Depth() == 1) {
+      break;
+    }
+  } while (head.Next());
+  if (head.Type() != EntityType::TAG || head.Depth() != 1) {
+    return results;
+  }
+  auto   first    = head.RawValue().data() - 1;
+  auto   root_end = FindRootEnd(aData, aSize, root);
+  size_t threads  = aThreads ? aThreads : std::thread::hardware_concurrency();
+  size_t count    = 0;
+  if (root_end) {
+    count = std::min(threads, size_t(root_end - first) / (aMinChunk + 1));
+  }
+
+  // Chunks start at tags named like the first child, roughly evenly.
+  std::vector<const char*> begins = {first};
+  auto                     opening = "<" + std::string(head.RawValue());
+  for (size_t k = 1; k < count; ++k) {
+    auto from  = std::max(first + k * ((root_end - first) / count),
+                         begins.back() + 1);
+    auto begin = FindTag(from, root_end, opening);
+    if (begin == root_end) {
+      break;
+    }
+    begins.push_back(begin);
+  }
+  if (begins.size() == 1) {
+    ReadChildren(head, 1, aData + aSize, aRead, results);
+    return results;
+  }
+  auto limit = [&](size_t aChunk) {
+    return aChunk + 1 < begins.size() ? begins[aChunk + 1] : root_end;
+  };
+
+  struct Part
+  {
+    std::vector<Result> mResults;
+    const char*         mEnd = nullptr;
+  };
+  std::vector<std::future<Part>> parts;
+  for (size_t k = 1; k < begins.size(); ++k) {
+    auto begin = begins[k];
+    auto end   = limit(k);
+    parts.push_back(
+      std::async(std::launch::async, [=, read = aRead]() mutable {
+        Part   part;
+        Parser parser(begin, root_end - begin);
+        part.mEnd = ReadChildren(parser, 0, end, read, part.mResults);
+        return part;
+      }));
+  }
+
+  // The first chunk is read by the head, within the real root.
+  auto   position = ReadChildren(head, 1, limit(0), aRead, results);
+  size_t kept     = results.size();
+  try {
+    for (size_t k = 1; k < begins.size(); ++k) {
+      Part               part;
+      std::exception_ptr error;
+      try {
+        part = parts[k - 1].get();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      if (position == begins[k]) {
+        if (error) {
+          std::rethrow_exception(error);
+        }
+        std::move(part.mResults.begin(),
+                  part.mResults.end(),
+                  std::back_inserter(results));
+        position = part.mEnd ? part.mEnd : root_end;
+      } else if (position && position < limit(k)) {
+        // Not split at a child of the root, so read again from where it is.
+        Parser parser(position, root_end - position);
+        position = ReadChildren(parser, 0, limit(k), aRead, results);
+        if (!position) {
+          position = root_end;
+        }
+      }
+    }
+  } catch (const ParserError&) {
+    // A chunk has no tag stack, so it can not tell a stray closing tag
+    // from the end of a root followed by another. The head goes on from
+    // the first chunk instead, and reports the error as one thread would.
+    results.erase(results.begin() + kept, results.end());
+    ReadChildren(head, 1, aData + aSize, aRead, results);
+  }
+  return results;
+}
+}
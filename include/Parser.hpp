@@ -1,13 +1,23 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cstdint>
 #include <cstring>
 #include <functional>
-#include <map>
-#include <stack>
+#include <memory>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
-#include <uchar.h>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "MappedInput.hpp"
+#include "NameTable.hpp"
+#include "charClass.hpp"
+#include "simd.hpp"
+#include "utf8.hpp"
 
 namespace xmlpp {
 /**
@@ -18,6 +28,34 @@ class ParserError : public std::runtime_error
   using std::runtime_error::runtime_error;
 };
 
+/**
+ * @brief Appends the char an entity or character reference stands for.
+ *
+ * aName is what goes between the '&' and the ';', like "amp" or "#x41".
+ * @throw ParserError if it is unknown or invalid.
+ */
+void DecodeEntity(std::string_view aName, std::string& aOut);
+
+/**
+ * @brief Checks an entity or character reference, like DecodeEntity().
+ *
+ * Nothing is decoded or written.
+ * @throw ParserError if it is unknown or invalid.
+ */
+void CheckEntity(std::string_view aName);
+
+/**
+ * @brief Converts a value to an integer, a floating point or a bool.
+ *
+ * Numbers are read with std::from_chars, straight from the view and
+ * regardless of the locale, and may have surrounding blanks and a leading
+ * '+'. Bools are true, false, 1 or 0.
+ * @throw ParserError telling what is wrong and where, if it is not a valid
+ * T or is out of its range.
+ */
+template<typename T>
+T ParseValue(std::string_view aText);
+
 /**
  * Represent the type of a given entity
  */
@@ -30,12 +68,231 @@ enum class EntityType
   TEXT        //!< TEXT A text
 };
 
+/**
+ * @brief The optional events a Parser reports, as a mask of flags.
+ *
+ * Tags and tag endings are always reported. Masked out entities are only
+ * scanned past: masked comments are not looked into, and masked texts are
+ * neither decoded nor checked for invalid escape sequences.
+ */
+enum class EventMask : unsigned
+{
+  NONE     = 0,                //!< NONE Only tags and tag endings
+  COMMENTS = 1,                //!< COMMENTS Comments
+  TEXTS    = 2,                //!< TEXTS Texts, CDATA sections included
+  ALL      = COMMENTS | TEXTS, //!< ALL Every event, the default
+};
+
+constexpr EventMask
+operator|(EventMask aLeft, EventMask aRight)
+{
+  return EventMask(unsigned(aLeft) | unsigned(aRight));
+}
+
+constexpr EventMask
+operator&(EventMask aLeft, EventMask aRight)
+{
+  return EventMask(unsigned(aLeft) & unsigned(aRight));
+}
+
+constexpr EventMask
+operator~(EventMask aMask)
+{
+  return EventMask(~unsigned(aMask) & unsigned(EventMask::ALL));
+}
+
+/**
+ * @brief The parameters of a tag, in document order.
+ *
+ * It is a flat vector of (name, value) views, so lookups are linear, which
+ * beats hashing for the handful of parameters a tag usually has. Names and
+ * plain values point into the input buffer, values with escape sequences
+ * point into an internal buffer. The storage is reused from tag to tag, so
+ * no allocation happens once it is warm.
+ */
+class ParamsMap
+{
+public:
+  using value_type     = std::pair<std::string_view, std::string_view>;
+  using const_iterator = std::vector<value_type>::const_iterator;
+  using iterator       = const_iterator;
+
+  ParamsMap() = default;
+
+  ParamsMap(const ParamsMap& aOther);
+
+  ParamsMap(ParamsMap&& aOther) noexcept;
+
+  ParamsMap& operator=(const ParamsMap& aOther);
+
+  ParamsMap& operator=(ParamsMap&& aOther) noexcept;
+
+  const_iterator begin() const { return mItems.begin(); }
+
+  const_iterator end() const { return mItems.end(); }
+
+  size_t size() const { return mItems.size(); }
+
+  bool empty() const { return mItems.empty(); }
+
+  /**
+   * @brief Returns an iterator to the given parameter, or end().
+   */
+  const_iterator find(std::string_view aName) const;
+
+  /**
+   * @brief Returns 1 if the parameter is present, 0 otherwise.
+   */
+  size_t count(std::string_view aName) const { return find(aName) != end(); }
+
+  /**
+   * @brief Returns the parameter value.
+   * @throw std::out_of_range if not present.
+   */
+  std::string_view at(std::string_view aName) const;
+
+  /**
+   * @brief Returns the parameter value or an empty view if not present.
+   */
+  std::string_view operator[](std::string_view aName) const;
+
+  /**
+   * @brief Returns the parameter value, converted with ParseValue().
+   * @throw std::out_of_range if not present.
+   * @throw ParserError if it is not a valid T.
+   */
+  template<typename T>
+  T As(std::string_view aName) const
+  {
+    return sParse<T>(aName, at(aName));
+  }
+
+  /**
+   * @brief Returns the parameter value converted, or aDefault if not present.
+   * @throw ParserError if it is not a valid T.
+   */
+  template<typename T>
+  T As(std::string_view aName, T aDefault) const
+  {
+    auto it = find(aName);
+    return it == end() ? aDefault : sParse<T>(aName, it->second);
+  }
+
+  /**
+   * @brief Returns the interned id of the parameter's name.
+   *
+   * It is NameTable::NO_ID unless the parser has a NameTable.
+   */
+  NameTable::Id NameId(const_iterator aParam) const
+  {
+    size_t index = aParam - begin();
+    return index < mIds.size() ? mIds[index] : NameTable::NO_ID;
+  }
+
+private:
+  friend class Parser;
+
+  std::vector<value_type>    mItems;
+  std::vector<NameTable::Id> mIds;
+  std::string                mDecoded;
+  const char*                mDecodedData = nullptr;
+
+  void mClear();
+
+  void mPush(std::string_view aName, std::string_view aValue);
+
+  void mPushDecoded(std::string_view aName, size_t aOffset);
+
+  void mRebase(const char* aOldData, size_t aOldSize);
+
+  template<typename T>
+  static T sParse(std::string_view aName, std::string_view aValue);
+};
+
+/**
+ * @brief A batch of events, stored as parallel arrays.
+ *
+ * Filled by Parser::NextBatch(), so events can be processed in tight loops
+ * over each array, like filtering by type or depth. The i-th event has
+ * Types()[i], Names()[i], Values()[i] and Depths()[i], and its parameters
+ * are Attributes()[AttributeOffsets()[i]] up to
+ * Attributes()[AttributeOffsets()[i + 1]].
+ *
+ * Views point into the input buffer when it outlives the parser's position,
+ * otherwise into the batch's own storage. Either way they are valid until
+ * the batch is filled again.
+ */
+class EventBatch
+{
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 256;
+
+  using Attribute = ParamsMap::value_type;
+
+  explicit EventBatch(size_t aCapacity = DEFAULT_CAPACITY);
+
+  size_t size() const { return mTypes.size(); }
+  bool   empty() const { return mTypes.empty(); }
+  size_t capacity() const { return mCapacity; }
+
+  const std::vector<EntityType>& Types() const { return mTypes; }
+
+  /**
+   * @brief The tag names, empty for comments and texts.
+   */
+  const std::vector<std::string_view>& Names() const { return mNames; }
+
+  /**
+   * @brief The values, with the same meaning as Parser::Value().
+   */
+  const std::vector<std::string_view>& Values() const { return mValues; }
+
+  /**
+   * @brief The depths, as given by Parser::Depth().
+   */
+  const std::vector<uint32_t>& Depths() const { return mDepths; }
+
+  /**
+   * @brief Where each event's parameters start, plus a final end offset.
+   */
+  const std::vector<uint32_t>& AttributeOffsets() const
+  {
+    return mAttributeOffsets;
+  }
+
+  const std::vector<Attribute>& Attributes() const { return mAttributes; }
+
+private:
+  friend class Parser;
+
+  static constexpr size_t BLOCK_SIZE = 4096;
+
+  size_t                        mCapacity;
+  std::vector<EntityType>       mTypes;
+  std::vector<std::string_view> mNames;
+  std::vector<std::string_view> mValues;
+  std::vector<uint32_t>         mDepths;
+  std::vector<uint32_t>         mAttributeOffsets;
+  std::vector<Attribute>        mAttributes;
+  // Blocks never move, so views into them stay valid as more are added.
+  std::vector<std::pair<std::unique_ptr<char[]>, size_t>> mBlocks;
+  size_t                                                  mBlock = 0;
+  size_t                                                  mUsed  = 0;
+
+  void mClear();
+
+  std::string_view mKeep(std::string_view aText, bool aCopy);
+};
+
 /**
  * @brief A parser adhering to SAX interface.
  *
  * The class itself acts as an iterator, a forward one. So each
  * time you call next() (or operator++()) it will advance to next
  * entity, in a Depth first approach.
+ *
+ * A parser must not be shared between threads, not even as a const
+ * reference: the const Value() decodes into internal buffers.
  */
 class Parser
 {
@@ -43,19 +300,85 @@ public:
   static constexpr const char* BLANKS = " \t\n\r";
   /**
    * @brief constructor that takes a c-string with the content.
+   *
+   * Only the events in aEvents are reported, see EventMask.
+   */
+  Parser(const char* aCode, EventMask aEvents = EventMask::ALL);
+
+  /**
+   * @brief constructor that takes a buffer of aSize chars.
+   *
+   * The buffer does not need a terminator, so a slice of a larger buffer
+   * can be parsed in place. A NUL char inside it is reported as an error.
    */
-  Parser(const char* aCode);
+  Parser(const char* aData,
+         size_t      aSize,
+         EventMask   aEvents = EventMask::ALL);
 
   /**
-   * Ctor based on simplified loader
+   * @brief Ctor based on simplified loader.
+   *
+   * The loader is called whenever the parser reaches the end of the current
+   * chunk, and must return the next c-string chunk, or nullptr (or an empty
+   * string) once the input ended. A chunk only needs to stay valid until the
+   * next call, so the loader may reuse a single buffer.
+   *
+   * Tokens spanning chunks are kept in an internal window, so the memory
+   * used is bounded by the chunk and the largest token sizes, not by the
+   * document size.
    */
-  Parser(std::function<const char*()> aLoader)
-    : mLoader(std::move(aLoader))
+  Parser(std::function<const char*()> aLoader,
+         EventMask                    aEvents = EventMask::ALL)
+    : mCode("")
+    , mEnd(mCode)
+    , mEvents(aEvents)
+    , mLoader(std::move(aLoader))
   {
-    mCode = mLoader();
     Next();
   }
 
+  /**
+   * @brief Ctor for push mode, where the input is given through Feed().
+   *
+   * Next() returns false whenever the next entity is not complete yet, and
+   * NeedsInput() tells it apart from the end of the document. Call Finish()
+   * once all the input was fed:
+   *
+   * @code
+   * Parser p;
+   * while (auto size = Receive(buffer)) {
+   *   p.Feed(buffer, size);
+   *   while (p.Next()) { ... }
+   * }
+   * p.Finish();
+   * while (p.Next()) { ... }
+   * @endcode
+   */
+  Parser()
+    : Parser(EventMask::ALL)
+  {
+  }
+
+  /**
+   * @brief Ctor for push mode, reporting only the events in aEvents.
+   */
+  explicit Parser(EventMask aEvents)
+    : mCode("")
+    , mEnd(mCode)
+    , mEvents(aEvents)
+    , mPushMode(true)
+  {
+  }
+
+  /**
+   * @brief Parses the given file in place, through a MappedInput.
+   *
+   * The parser, and any copy of it, keeps the file mapped.
+   * @throw std::system_error if the file can not be opened.
+   */
+  static Parser FromFile(const char* aPath,
+                         EventMask   aEvents = EventMask::ALL);
+
   /**
    * Advances to next entity.
    * @return true if successful, false if it ended.
@@ -65,8 +388,65 @@ public:
 
   Parser& operator++();
 
+  /**
+   * @brief Advances, returning a copy left at the previous entity.
+   *
+   * The copy keeps its own copy of the loader's current chunk, if it reads
+   * from one, so it can still be read and advanced once the loader reuses
+   * its buffer.
+   */
   Parser operator++(int);
 
+  /**
+   * @brief Advances over up to aBatch.capacity() entities, recording them.
+   *
+   * Like Next(), it starts after the current entity. The batch is cleared
+   * first, and the parser is left at its last entity.
+   * @return true if at least one entity was recorded.
+   * @throw ParserError if error.
+   */
+  bool NextBatch(EventBatch& aBatch);
+
+  /**
+   * @brief Moves from a tag to its ending, skipping everything in between.
+   *
+   * The content is only scanned for tag boundaries, with a vectorized
+   * search for '<'. Nothing is decoded, and no names are kept or checked
+   * except for the final ending. For other entities it is the same as
+   * Next().
+   *
+   * In push mode, when it returns false for lack of input, the next call
+   * of Next() or SkipElement() goes on skipping.
+   * @return true if successful, false if it ended.
+   * @throw ParserError if error.
+   */
+  bool SkipElement();
+
+  /**
+   * @brief Appends aSize chars to the input of a push mode parser.
+   *
+   * The chars are copied, so the buffer can be reused right away. Only the
+   * entity being scanned is kept along with them, so memory is bounded by
+   * the fragment and the largest entity sizes.
+   *
+   * The views of the current entity stay valid until the next call of
+   * Next() or Feed().
+   */
+  void Feed(const char* aData, size_t aSize);
+
+  /**
+   * @brief Tells a push mode parser no more input will be fed.
+   *
+   * The remaining entities can be read with Next(), which throws
+   * ParserError if the document was cut in the middle of an entity.
+   */
+  void Finish() { mInputEnded = true; }
+
+  /**
+   * @brief Returns true if the last Next() returned false for lack of input.
+   */
+  bool NeedsInput() const { return mNeedsInput; }
+
   /**
    * @brief returns the type of the current node.
    */
@@ -82,8 +462,69 @@ public:
    * | TAG_ENDING | the name of tag ("<root/>"'s name is root)                 |
    * | COMMENT    | the comment's content. No text transformation done. |
    * | TEXT       | the text's content, with the escaping sequences translated |
+   *
+   * Prefer ValueView() when a copy is not needed. Texts are only decoded
+   * when their value is first asked for, so although const this call may
+   * write the parser's internal value buffer, and two threads must not
+   * call it on the same parser.
+   */
+  const std::string& Value() const
+  {
+    if (!mValueOwned) {
+      if (mHasEscapes) {
+        sDecodeText(mView, mValue);
+      } else {
+        mValue.assign(mView);
+      }
+      mValueOwned = true;
+    }
+    return mValue;
+  }
+
+  /**
+   * @brief Returns the value of the current node, without copying it.
+   *
+   * Same meaning as Value(), but when the entity has no escapes or CDATA
+   * the view points straight into the input buffer. Only decoded values
+   * live in an internal buffer, filled by Value() on the first call.
+   *
+   * The view is valid until the next call of next() or operator++().
+   */
+  std::string_view ValueView() const
+  {
+    return mValueOwned || mHasEscapes ? std::string_view(Value()) : mView;
+  }
+
+  /**
+   * @brief Returns the current node as it is in the input.
+   *
+   * For texts escape sequences and CDATA sections are kept as they are, so
+   * a text can be passed along without ever being decoded. For other
+   * entities it is the same as ValueView().
+   *
+   * The view is valid until the next call of next() or operator++().
+   */
+  std::string_view RawValue() const { return mView; }
+
+  /**
+   * @brief Returns true if the current text has escapes or CDATA sections.
+   *
+   * Otherwise RawValue() is already the decoded value.
+   */
+  bool HasEscapes() const { return mHasEscapes; }
+
+  /**
+   * @brief Returns the current value, converted with ParseValue().
+   *
+   * Values without escapes are read in place, without any copy. Others
+   * are decoded first, like with ValueView().
+   * @throw ParserError if it is not a valid T.
    */
-  const std::string& Value() const { return mValue; }
+  template<typename T>
+  T ValueAs() const
+  {
+    return ParseValue<T>(ValueView());
+  }
 
   /**
    * @brief the type of the parameters map.
@@ -93,7 +534,7 @@ public:
    * We guaranteed that it defines an iterator, the operator[], the begin(),
    * end(), count() and size() and is able to be used with range-for.
    */
-  using ParamsMap = std::unordered_map<std::string, std::string>;
+  using ParamsMap = xmlpp::ParamsMap;
 
   /**
    * @brief Return the current parameters.
@@ -102,6 +543,39 @@ public:
    */
   const ParamsMap& Parameters() const { return mParams; }
 
+  /**
+   * @brief Returns how many tags enclose the current entity.
+   *
+   * A tag and its ending have the same depth, one less than their content.
+   */
+  size_t Depth() const
+  {
+    bool opened = mType == EntityType::TAG && !mSingletag;
+    return mTagStack.size() - opened;
+  }
+
+  /**
+   * @brief Sets the table where tag and parameter names are interned.
+   *
+   * From then on every name is looked up, and registered if new, as tags
+   * are scanned. The current tag is resolved right away. Pass nullptr to
+   * stop interning. The table must outlive the parser.
+   */
+  void Names(NameTable* aNames);
+
+  /**
+   * @brief Returns the table set by Names(NameTable*), if any.
+   */
+  NameTable* Names() const { return mNames; }
+
+  /**
+   * @brief Returns the interned id of the current tag's name.
+   *
+   * It is NameTable::NO_ID for comments and texts, or if no NameTable was
+   * set.
+   */
+  NameTable::Id NameId() const { return mNameId; }
+
   /**
    * @brief Return the document's encoding.
    *
@@ -121,16 +595,44 @@ public:
 
 private:
   const char*                  mCode;
-  EntityType                   mType;
-  std::string                  mValue;
+  const char*                  mEnd;
+  EntityType                   mType   = EntityType::TEXT;
+  EventMask                    mEvents = EventMask::ALL;
+  std::string_view             mView;
+  mutable std::string          mValue;
+  mutable bool                 mValueOwned = false;
+  bool                         mHasEscapes = false;
   ParamsMap                    mParams;
   bool                         mSingletag   = false;
   bool                         mInitialized = false;
   std::string                  mVersion     = "1.0";
-  std::stack<std::string>      mTagStack;
-  std::function<const char*()> mLoader;
+  // Names of the open tags, as views into the input buffer.
+  std::vector<std::string_view> mTagStack;
+  NameTable*                    mNames  = nullptr;
+  NameTable::Id                 mNameId = NameTable::NO_ID;
+  std::function<const char*()>  mLoader;
+  bool                          mPushMode   = false;
+  bool                          mInputEnded = false;
+  bool                          mNeedsInput = false;
+  // How many open tags SkipElement() still has to go through.
+  size_t mSkipDepth = 0;
+  // Owned copies of tokens spanning chunks and of open tag names, shared
+  // with copies of this parser, so never changed while shared.
+  std::shared_ptr<std::string> mWindow;
+  std::shared_ptr<std::string> mSpareWindow;
+  std::shared_ptr<std::string> mTagNames;
+  std::shared_ptr<MappedInput> mInput;
+  // The loader's chunk mCode is in, or nullptr when it is in mWindow.
+  const char* mChunk = nullptr;
+
+  // Thrown when the current token needs more input than loaded.
+  struct NeedMore
+  {
+  };
 
 private:
+  bool mNextEntity(const char*& aTokenBegin);
+
   void mNextTag();
 
   void mNextComment();
@@ -139,49 +641,301 @@ private:
 
   void mNextDeclaration();
 
-  std::string mCdataSequence();
-  std::string mEscapeSequence();
+  void mCdataSequence();
+
+  std::string_view mEscapeSequence();
+
+  static void sDecodeText(std::string_view aText, std::string& aOut);
 
   void mReadParameters();
 
+  void mSkipContent(const char*& aTokenBegin);
+
+  void mSkipComment();
+
+  void mSkipText();
+
+  void mSkipPast(size_t aOffset, std::string_view aEnd);
+
+  void mResolveNames();
+
   void mExpect(char aExpected);
 
-  void mEnsure(char aExpected);
+  void mEnsure(char aExpected);
+
+  size_t mIgnoreBlanks();
+
+  void mSkipName();
+
+  void mSetValue(const char* aBegin, const char* aEnd);
+
+  char mChar() const { return mCode != mEnd ? *mCode : 0; }
+
+  bool mReports(EventMask aEvents) const
+  {
+    return (mEvents & aEvents) != EventMask::NONE;
+  }
+
+  bool mMoreInput() const { return (mLoader || mPushMode) && !mInputEnded; }
+
+  [[noreturn]] void mError(const std::string& aMessage);
+
+  char mPeek(size_t aOffset);
+
+  void mLoad();
+
+  void mKeepTagNames();
+
+  void mOwnChunk();
+
+  static std::shared_ptr<std::string> sReuse(
+    std::shared_ptr<std::string>& aBuffer);
+};
+
+inline Parser
+Parser::FromFile(const char* aPath, EventMask aEvents)
+{
+  auto   input = std::make_shared<MappedInput>(aPath);
+  Parser parser(input->Data(), input->Size(), aEvents);
+  parser.mInput = std::move(input);
+  return parser;
+}
+
+inline bool
+Parser::Next()
+{
+  if (mSingletag) {
+    // The ending reports no parameters, as a real closing tag would not.
+    mType      = EntityType::TAG_ENDING;
+    mSingletag = false;
+    mParams.mClear();
+    return true;
+  }
+  mNeedsInput = false;
+  for (;;) {
+    auto token_beg = mCode;
+    try {
+      if (mSkipDepth) {
+        mSkipContent(token_beg);
+      }
+      return mNextEntity(token_beg);
+    } catch (const NeedMore&) {
+      mCode = token_beg;
+      if (mPushMode) {
+        mNeedsInput = true;
+        return false;
+      }
+      mLoad();
+    }
+  }
+}
+
+inline bool
+Parser::NextBatch(EventBatch& aBatch)
+{
+  aBatch.mClear();
+  // Streamed input is overwritten as the parser goes on.
+  bool copy = mLoader || mPushMode;
+  while (aBatch.size() < aBatch.capacity() && Next()) {
+    auto view  = ValueView();
+    auto value = aBatch.mKeep(view, copy || mValueOwned);
+    bool tag   = mType == EntityType::TAG || mType == EntityType::TAG_ENDING;
+    aBatch.mTypes.push_back(mType);
+    aBatch.mNames.push_back(tag ? value : std::string_view());
+    aBatch.mValues.push_back(value);
+    aBatch.mDepths.push_back(uint32_t(Depth()));
+    auto&                        decoded = mParams.mDecoded;
+    std::less_equal<const char*> le;
+    std::less<const char*>       lt;
+    for (auto& param : mParams) {
+      bool owned  = le(decoded.data(), param.second.data()) &&
+                   lt(param.second.data(), decoded.data() + decoded.size());
+      auto pname  = aBatch.mKeep(param.first, copy);
+      auto pvalue = aBatch.mKeep(param.second, copy || owned);
+      aBatch.mAttributes.emplace_back(pname, pvalue);
+    }
+    aBatch.mAttributeOffsets.push_back(uint32_t(aBatch.mAttributes.size()));
+  }
+  return !aBatch.empty();
+}
+
+inline bool
+Parser::SkipElement()
+{
+  // After running out of input the skip, if any, is already under way.
+  if (mType == EntityType::TAG && !mSingletag && !mNeedsInput) {
+    mSkipDepth = 1;
+  }
+  return Next();
+}
+
+inline void
+Parser::mSkipContent(const char*& aTokenBegin)
+{
+  while (mSkipDepth) {
+    mCode = ScanUntil(mCode, mEnd, '<', '<');
+    if (mCode == mEnd) {
+      if (mMoreInput()) {
+        throw NeedMore{};
+      }
+      mSkipDepth = 0;
+      return;
+    }
+    if (*mCode == 0) {
+      mError("Unexpected NUL char");
+    }
+    auto next = mPeek(1);
+    if (next == '/') {
+      if (mSkipDepth == 1) {
+        // Left for mNextTag(), to check it against the tag stack.
+        mSkipDepth = 0;
+        return;
+      }
+      mSkipPast(2, ">");
+      --mSkipDepth;
+    } else if (next == '!') {
+      auto third = mPeek(2);
+      if (third == '-') {
+        mSkipPast(4, "-->");
+      } else if (third == '[') {
+        mSkipPast(3, "]]>");
+      } else {
+        mError("Unsupported markup declaration.");
+      }
+    } else if (next == '?') {
+      mError("Invalid declaration or using processor instruction, "
+             "which aren't currently implemented.");
+    } else {
+      // Parameter values can not hold '>', so the first one ends the tag.
+      mSkipPast(1, ">");
+      if (mCode[-2] != '/') {
+        ++mSkipDepth;
+      }
+    }
+    aTokenBegin = mCode;
+  }
+}
+
+inline void
+Parser::mSkipComment()
+{
+  mEnsure('<');
+  mEnsure('!');
+  mExpect('-');
+  mExpect('-');
+  mSkipPast(0, "-->");
+}
+
+inline void
+Parser::mSkipText()
+{
+  for (;;) {
+    mCode = ScanUntil(mCode, mEnd, '<', '<');
+    if (mCode == mEnd) {
+      if (mMoreInput()) {
+        throw NeedMore{};
+      }
+      return;
+    }
+    if (*mCode == 0) {
+      mError("Unexpected NUL char");
+    }
+    if (mPeek(1) != '!' || mPeek(2) != '[') {
+      return;
+    }
+    mSkipPast(3, "]]>");
+  }
+}
+
+inline void
+Parser::mSkipPast(size_t aOffset, std::string_view aEnd)
+{
+  auto from = mCode + std::min(aOffset, size_t(mEnd - mCode));
+  for (auto end = from;; ++end) {
+    end = ScanUntil(end, mEnd, '>', '>');
+    if (end == mEnd || *end == 0) {
+      mCode = end;
+      mError("Expected '" + std::string(aEnd) + "' before end of the buffer");
+    }
+    if (size_t(end + 1 - from) >= aEnd.size() &&
+        std::equal(aEnd.begin(), aEnd.end(), end + 1 - aEnd.size())) {
+      mCode = end + 1;
+      return;
+    }
+  }
+}
 
-  size_t mIgnoreBlanks();
-};
+inline void
+Parser::Feed(const char* aData, size_t aSize)
+{
+  assert(mPushMode && !mInputEnded);
+  size_t pending = mEnd - mCode;
+  if (mWindow && mWindow.use_count() == 1 &&
+      mWindow->capacity() - mWindow->size() >= aSize) {
+    // Appending without reallocating keeps every view valid.
+    mWindow->append(aData, aSize);
+  } else {
+    mKeepTagNames();
+    auto window = sReuse(mSpareWindow);
+    window->reserve(2 * (pending + aSize));
+    window->assign(mCode, pending);
+    window->append(aData, aSize);
+    mSpareWindow = std::move(mWindow);
+    mWindow      = std::move(window);
+  }
+  mEnd  = mWindow->data() + mWindow->size();
+  mCode = mEnd - pending - aSize;
+}
 
 inline bool
-Parser::Next()
+Parser::mNextEntity(const char*& aTokenBegin)
 {
-  using namespace std;
-  if (mSingletag) {
-    mType      = EntityType::TAG_ENDING;
-    mSingletag = false;
-    return true;
-  }
-  if (*mCode == 0) {
-    return false;
-  }
-  auto space = mIgnoreBlanks();
-  if (*mCode == '<') {
-    if (*(mCode + 1) == '!') {
-      if (*(mCode + 2) == '-') {
-        mNextComment();
-      } else if (*(mCode + 2) == '[') {
-        mNextText();
+  // Masked out entities are scanned past, then the next one is tried.
+  for (;; aTokenBegin = mCode) {
+    if (mCode == mEnd) {
+      if (mMoreInput()) {
+        throw NeedMore{};
+      }
+      return false;
+    }
+    mNameId = NameTable::NO_ID;
+    mParams.mClear();
+    auto space = mIgnoreBlanks();
+    if (mChar() == '<') {
+      auto next = mPeek(1);
+      if (next == '!') {
+        auto third = mPeek(2);
+        if (third == '-') {
+          if (!mReports(EventMask::COMMENTS)) {
+            mSkipComment();
+            continue;
+          }
+          mNextComment();
+        } else if (third == '[') {
+          if (!mReports(EventMask::TEXTS)) {
+            mSkipText();
+            continue;
+          }
+          mNextText();
+        } else {
+          mError("Unsupported markup declaration.");
+        }
+      } else if (next == '?') {
+        mNextDeclaration();
+        return Next();
+      } else {
+        mNextTag();
       }
-    } else if (*(mCode + 1) == '?') {
-      mNextDeclaration();
-      return Next();
     } else {
-      mNextTag();
+      if (!mReports(EventMask::TEXTS)) {
+        mSkipText();
+        continue;
+      }
+      mCode -= space;
+      mNextText();
     }
-  } else {
-    mCode -= space;
-    mNextText();
+    return true;
   }
-  return true;
 }
 
 inline xmlpp::Parser& Parser::operator++()
@@ -193,6 +947,7 @@ inline xmlpp::Parser& Parser::operator++()
 inline xmlpp::Parser Parser::operator++(int)
 {
   auto temp = *this;
+  temp.mOwnChunk();
   Next();
   return temp;
 }
@@ -201,90 +956,103 @@ inline void
 Parser::mNextTag()
 {
   using namespace std;
-  assert(*mCode == '<');
+  assert(mChar() == '<');
   auto tag_beg = ++mCode;
-  bool closing = false;
-  if (*mCode == '/') {
-    closing = true;
+  if (mChar() == '/') {
     tag_beg = ++mCode;
     mType   = EntityType::TAG_ENDING;
   } else {
     mType = EntityType::TAG;
   }
-  for (; *mCode != 0; ++mCode) {
-    if (strchr(BLANKS, *mCode) || *mCode == '>' || *mCode == '/') {
-      mValue.assign(tag_beg, mCode);
-      mReadParameters();
-      break;
-    }
+  if (!IsNameStart(mChar())) {
+    mError("Invalid tag name.");
+  }
+  mSkipName();
+  mSetValue(tag_beg, mCode);
+  mReadParameters();
+  bool single = mType == EntityType::TAG && mChar() == '/';
+  if (single) {
+    ++mCode;
+  }
+  if (mChar() != '>') {
+    mError("Unclosed tag.");
+  }
+  ++mCode;
+  if (mNames) {
+    mResolveNames();
   }
   if (mType == EntityType::TAG) {
-    if (*mCode == '/') {
-      ++mCode;
+    if (single) {
       mSingletag = true;
     } else {
-      mTagStack.push(mValue);
+      mTagStack.push_back(mView);
     }
   } else {
-    if (mTagStack.top() != mValue) {
-      throw ParserError("Tag mismatch, opened with: " + mTagStack.top() +
-                        ", but closed with: " + mValue);
+    if (mTagStack.empty()) {
+      throw ParserError("Unexpected closing tag: " + std::string(mView));
     }
-    mTagStack.pop();
-  }
-  if (*mCode == '>') {
-    ++mCode;
-  } else {
-    throw ParserError("Unclosed tag.");
+    if (mTagStack.back() != mView) {
+      throw ParserError("Tag mismatch, opened with: " +
+                        std::string(mTagStack.back()) +
+                        ", but closed with: " + std::string(mView));
+    }
+    mTagStack.pop_back();
   }
 }
 
 inline void
 Parser::mNextComment()
 {
-  assert(*mCode++ == '<');
-  assert(*mCode++ == '!');
+  mEnsure('<');
+  mEnsure('!');
   mExpect('-');
   mExpect('-');
   auto   comment_beg = mCode;
   size_t level       = 0;
-  for (; *mCode != 0; ++mCode) {
+  for (; mCode != mEnd && *mCode != 0; ++mCode) {
     if (*mCode == '-')
       ++level;
     else if (*mCode == '>' && level >= 2) {
       mType = EntityType::COMMENT;
-      mValue.assign(comment_beg, mCode - 2);
+      mSetValue(comment_beg, mCode - 2);
       ++mCode;
       return;
     } else
       level = 0;
   }
-  throw ParserError("Expected '-->' before end of the buffer");
+  mError("Expected '-->' before end of the buffer");
 }
 
 inline void
 Parser::mNextText()
 {
   auto text_beg = mCode;
-  mValue.clear();
-  for (; *mCode != 0; ++mCode) {
-    if (*mCode == '<') {
-      if (*(mCode + 1) == '!' && *(mCode + 2) == '[') {
-        mValue.append(text_beg, mCode);
-        mValue.append(mCdataSequence());
-        text_beg = mCode--;
-      } else {
-        break;
+  bool escapes  = false;
+  for (;;) {
+    mCode = ScanUntil(mCode, mEnd, '<', '&');
+    if (mCode == mEnd) {
+      if (mMoreInput()) {
+        throw NeedMore{};
       }
+      break;
+    }
+    if (*mCode == 0) {
+      mError("Unexpected NUL char");
     }
+    if (*mCode == '<' && (mPeek(1) != '!' || mPeek(2) != '[')) {
+      break;
+    }
+    // Only checked here, the text is decoded by Value() if ever needed.
+    escapes = true;
     if (*mCode == '&') {
-      mValue.append(text_beg, mCode);
-      mValue.append(mEscapeSequence());
-      text_beg = mCode--;
+      CheckEntity(mEscapeSequence());
+    } else {
+      mCdataSequence();
     }
   }
   mType = EntityType::TEXT;
-  mValue.append(text_beg, mCode);
+  mSetValue(text_beg, mCode);
+  mHasEscapes = escapes;
 }
 
 inline void
@@ -294,8 +1062,8 @@ Parser::mNextDeclaration()
     throw ParserError("Invalid declaration or using processor instruction, "
                       "which aren't currently implemented.");
   }
-  assert(*mCode++ == '<');
-  assert(*mCode++ == '?');
+  mEnsure('<');
+  mEnsure('?');
   mExpect('x');
   mExpect('m');
   mExpect('l');
@@ -303,21 +1071,21 @@ Parser::mNextDeclaration()
   if (mParams.count("encoding")) {
     auto encoding = mParams["encoding"];
     if (encoding != "UTF-8") {
-      throw ParserError("Invalid encoding:" + encoding);
+      throw ParserError("Invalid encoding:" + std::string(encoding));
     }
   }
   if (mParams.count("version")) {
     mVersion = mParams["version"];
   }
+  mParams.mClear();
   mExpect('?');
   mExpect('>');
   mInitialized = true;
 }
 
-inline std::string
+inline void
 Parser::mCdataSequence()
 {
-  using namespace std;
   mEnsure('<');
   mEnsure('!');
   mEnsure('[');
@@ -327,145 +1095,241 @@ Parser::mCdataSequence()
   mExpect('T');
   mExpect('A');
   mExpect('[');
-  auto   cdata_beg = mCode;
-  string result;
-  for (; *mCode != 0; ++mCode) {
-    if (*mCode == ']' && *(mCode + 1) == ']' && *(mCode + 2) == '>') {
-      result.assign(cdata_beg, mCode);
-      break;
+  for (; mCode != mEnd && *mCode != 0; ++mCode) {
+    if (*mCode == ']' && mPeek(1) == ']' && mPeek(2) == '>') {
+      mCode += 3;
+      return;
+    }
+  }
+  mError("Expected ']]>' before end of the buffer");
+}
+
+inline void
+Parser::sDecodeText(std::string_view aText, std::string& aOut)
+{
+  // The text was checked by mNextText(), so every sequence is complete.
+  constexpr size_t CDATA_BEGIN = sizeof("<![CDATA[") - 1;
+  aOut.clear();
+  auto code = aText.data();
+  auto end  = code + aText.size();
+  for (;;) {
+    auto sequence = ScanUntil(code, end, '&', '<');
+    aOut.append(code, sequence);
+    if (sequence == end) {
+      return;
+    }
+    if (*sequence == '&') {
+      code = std::find(sequence, end, ';');
+      DecodeEntity(std::string_view(sequence + 1, code - sequence - 1), aOut);
+      code += 1;
+    } else {
+      auto content = sequence + CDATA_BEGIN;
+      code         = std::search(content, end, "]]>", "]]>" + 3);
+      aOut.append(content, code);
+      code += 3;
     }
   }
-  mEnsure(']');
-  mEnsure(']');
-  mEnsure('>');
-  return result;
 }
 
-inline std::string
+// Scans an entity or character reference, returning what is in between.
+inline std::string_view
 Parser::mEscapeSequence()
 {
-  using namespace std;
   mEnsure('&');
   auto escape_beg = mCode;
-  for (; *mCode != 0; ++mCode) {
-    if (*mCode == ';') {
-      std::string escape(escape_beg, mCode);
-      mEnsure(';');
-      if (escape[0] == '#') {
-        char32_t value = 0;
-        if (escape[1] == 'x') {
-          for (size_t i = 2; i < escape.size(); ++i) {
-            value *= 0x10;
-            if (isdigit(escape[i])) {
-              value += escape[i] & 0xf;
-            } else if (isupper(escape[i])) {
-              value += (escape[i] - 'A') | 0xA;
-            } else {
-              value += (escape[i] - 'a') | 0xA;
-            }
-          }
-        } else {
-          for (size_t i = 1; i < escape.size(); ++i) {
-            value *= 10;
-            value += escape[i] & 0xf;
-          }
-        }
-        if (value) {
-          if (value < 0x7f) {
-            return {char(value)};
-          } else {
-            string locale = std::setlocale(LC_ALL, nullptr);
-            std::setlocale(LC_ALL, "en_US.utf8");
-            char           buffer[MB_CUR_MAX + 1];
-            std::mbstate_t state{};
-            auto           end = c32rtomb(buffer, value, &state);
-            buffer[end]        = 0;
-            std::setlocale(LC_ALL, locale.c_str());
-            return string(buffer);
-          }
-        }
-      }
-      static map<string, string> escapeMapping = {
-        {"lt", "<"}, {"gt", ">"}, {"amp", "&"}, {"quot", "\""}, {"apos", "'"}};
-      return escapeMapping[escape];
+  if (mChar() == '#') {
+    ++mCode;
+  }
+  while (IsNameChar(mChar())) {
+    ++mCode;
+  }
+  if (mChar() != ';' || mCode == escape_beg) {
+    mError("Invalid Escape Sequence");
+  }
+  std::string_view escape(escape_beg, mCode - escape_beg);
+  mEnsure(';');
+  return escape;
+}
+
+inline char32_t
+CharReferenceValue(std::string_view aReference)
+{
+  using namespace std;
+  bool     hex   = aReference.size() > 1 && aReference[1] == 'x';
+  size_t   i     = hex ? 2 : 1;
+  char32_t value = 0;
+  if (i == aReference.size()) {
+    throw ParserError("Empty character reference");
+  }
+  for (; i < aReference.size(); ++i) {
+    int digit = hex ? HexDigitValue(aReference[i])
+                    : DecimalDigitValue(aReference[i]);
+    if (digit < 0) {
+      throw ParserError("Invalid digit in character reference &" +
+                        string(aReference) + ";");
+    }
+    value = value * (hex ? 16 : 10) + digit;
+    if (value > 0x10FFFF) {
+      break;
     }
   }
-  throw ParserError("Invalid Escape Sequence");
+  bool surrogate = value >= 0xD800 && value <= 0xDFFF;
+  if (value == 0 || value > 0x10FFFF || surrogate) {
+    throw ParserError("Character reference &" + string(aReference) +
+                      "; is out of the valid range");
+  }
+  return value;
+}
+
+inline void
+AppendCharReference(std::string_view aReference, std::string& aOut)
+{
+  char buffer[UTF8_MAX_BYTES];
+  aOut.append(buffer, EncodeUtf8(CharReferenceValue(aReference), buffer));
+}
+
+inline char
+PredefinedEntity(std::string_view aName)
+{
+  switch (aName.size()) {
+    case 2:
+      if (aName[1] == 't') {
+        return aName[0] == 'l' ? '<' : aName[0] == 'g' ? '>' : 0;
+      }
+      break;
+    case 3:
+      return aName == "amp" ? '&' : 0;
+    case 4:
+      return aName == "quot" ? '"' : aName == "apos" ? '\'' : 0;
+  }
+  return 0;
+}
+
+inline void
+CheckEntity(std::string_view aName)
+{
+  if (!aName.empty() && aName[0] == '#') {
+    CharReferenceValue(aName);
+  } else if (!PredefinedEntity(aName)) {
+    throw ParserError("Unknown entity &" + std::string(aName) + ";");
+  }
+}
+
+inline void
+DecodeEntity(std::string_view aName, std::string& aOut)
+{
+  if (!aName.empty() && aName[0] == '#') {
+    AppendCharReference(aName, aOut);
+  } else if (auto c = PredefinedEntity(aName)) {
+    aOut += c;
+  } else {
+    throw ParserError("Unknown entity &" + std::string(aName) + ";");
+  }
 }
 
 inline void
 Parser::mReadParameters()
 {
   using namespace std;
+  mParams.mClear();
+  string_view pname;
 PARAM_NAME:
   mIgnoreBlanks();
-  string pname     = "";
-  auto   pname_beg = mCode;
-  for (; *mCode != 0; ++mCode) {
-    if (*mCode == '>' || *mCode == '/' || *mCode == '?') {
-      return;
+  if (mChar() == '>' || mChar() == '/' || mChar() == '?') {
+    return;
+  }
+  if (!IsNameStart(mChar())) {
+    if (mChar() == '=') {
+      mError("Invalid Parameter. A name is expected before the '='");
     }
-    if (*mCode == '=' || strchr(BLANKS, *mCode)) {
-      if (mCode == pname_beg) {
-        throw ParserError(
-          "Invalid Parameter. A name is expected before the '='");
-      }
-      pname.assign(pname_beg, mCode);
-      goto PARAM_VALUE;
+    if (mCode == mEnd) {
+      mError("Expected close tag or parameter definition");
     }
+    mError("Invalid char '"s + *mCode + "' in parameter name");
   }
-  throw ParserError("Expected close tag or parameter definition");
-PARAM_VALUE:
+  auto pname_beg = mCode;
+  mSkipName();
+  pname = string_view(pname_beg, mCode - pname_beg);
   mIgnoreBlanks();
-  if (*mCode != '=') {
-    mParams[pname] = pname;
+  if (mChar() != '=') {
+    mParams.mPush(pname, pname);
     goto PARAM_NAME;
   }
   ++mCode;
   mIgnoreBlanks();
-  if (!strchr("\"\'", *mCode)) {
-    throw ParserError(
-      "Invalid Parameter '" + pname +
+  if (!IsQuote(mChar())) {
+    mError(
+      "Invalid Parameter '" + string(pname) +
       "'. The parameter value must be surrounded by \' or \", we got: '" +
-      *mCode + "'");
+      mChar() + "'");
   }
-  char endToken   = *mCode++;
-  auto pvalue_beg = mCode++;
-  mParams[pname].clear();
-  for (; *mCode != 0; ++mCode) {
+  char   endToken   = *mCode++;
+  auto   pvalue_beg = mCode;
+  size_t decoded    = string::npos;
+  auto&  buffer     = mParams.mDecoded;
+  for (; mCode != mEnd && *mCode != 0; ++mCode) {
     if (*mCode == '>') {
       throw ParserError("Expected a \' or \" before <");
     }
     if (*mCode == '&') {
-      mParams[pname].append(pvalue_beg, mCode);
-      mParams[pname].append(mEscapeSequence());
+      if (decoded == string::npos) {
+        decoded = buffer.size();
+      }
+      buffer.append(pvalue_beg, mCode);
+      DecodeEntity(mEscapeSequence(), buffer);
       pvalue_beg = mCode--;
     }
     if (*mCode == endToken) {
-      mParams[pname].append(pvalue_beg, mCode);
+      if (decoded == string::npos) {
+        mParams.mPush(pname, string_view(pvalue_beg, mCode - pvalue_beg));
+      } else {
+        buffer.append(pvalue_beg, mCode);
+        mParams.mPushDecoded(pname, decoded);
+      }
       ++mCode;
       goto PARAM_NAME;
     }
   }
-  throw ParserError("Unclosed parameter value");
+  mError("Unclosed parameter value");
+}
+
+inline void
+Parser::Names(NameTable* aNames)
+{
+  mNames  = aNames;
+  mNameId = NameTable::NO_ID;
+  mParams.mIds.clear();
+  if (mNames &&
+      (mType == EntityType::TAG || mType == EntityType::TAG_ENDING)) {
+    mResolveNames();
+  }
+}
+
+inline void
+Parser::mResolveNames()
+{
+  mNameId = mNames->Register(mView);
+  mParams.mIds.clear();
+  for (auto& param : mParams) {
+    mParams.mIds.push_back(mNames->Register(param.first));
+  }
 }
 
 inline void
 Parser::mExpect(char aExpected)
 {
-  if (*mCode == aExpected) {
+  if (mChar() == aExpected) {
     ++mCode;
   } else {
     using namespace std;
-    throw ParserError("Expected char '"s + aExpected + "', got '" + *mCode +
-                      "'.");
+    mError("Expected char '"s + aExpected + "', got '" + mChar() + "'.");
   }
 }
 
 inline void
 Parser::mEnsure(char aExpected)
 {
-  assert(*mCode == aExpected);
+  assert(mChar() == aExpected);
   ++mCode;
 }
 
@@ -473,15 +1337,371 @@ inline size_t
 Parser::mIgnoreBlanks()
 {
   auto initial = mCode;
-  while (strchr(BLANKS, *mCode)) {
+  while (mCode != mEnd && IsBlank(*mCode)) {
     ++mCode;
   }
   return mCode - initial;
 }
 
-inline Parser::Parser(const char* aCode)
+inline void
+Parser::mSkipName()
+{
+  while (++mCode != mEnd && IsNameChar(*mCode)) {
+  }
+}
+
+inline ParamsMap::ParamsMap(const ParamsMap& aOther)
+  : mItems(aOther.mItems)
+  , mIds(aOther.mIds)
+  , mDecoded(aOther.mDecoded)
+{
+  mRebase(aOther.mDecoded.data(), aOther.mDecoded.size());
+}
+
+inline ParamsMap::ParamsMap(ParamsMap&& aOther) noexcept
+  : mItems(std::move(aOther.mItems))
+  , mIds(std::move(aOther.mIds))
+  , mDecoded(std::move(aOther.mDecoded))
+{
+  // Short decoded values may have been copied out of aOther's buffer.
+  mRebase(aOther.mDecodedData, mDecoded.size());
+  aOther.mClear();
+}
+
+inline ParamsMap&
+ParamsMap::operator=(const ParamsMap& aOther)
+{
+  mItems   = aOther.mItems;
+  mIds     = aOther.mIds;
+  mDecoded = aOther.mDecoded;
+  mRebase(aOther.mDecoded.data(), aOther.mDecoded.size());
+  return *this;
+}
+
+inline ParamsMap&
+ParamsMap::operator=(ParamsMap&& aOther) noexcept
+{
+  if (this != &aOther) {
+    mItems   = std::move(aOther.mItems);
+    mIds     = std::move(aOther.mIds);
+    mDecoded = std::move(aOther.mDecoded);
+    mRebase(aOther.mDecodedData, mDecoded.size());
+    aOther.mClear();
+  }
+  return *this;
+}
+
+inline ParamsMap::const_iterator
+ParamsMap::find(std::string_view aName) const
+{
+  auto it = mItems.begin();
+  for (; it != mItems.end(); ++it) {
+    if (it->first == aName) {
+      break;
+    }
+  }
+  return it;
+}
+
+inline std::string_view
+ParamsMap::at(std::string_view aName) const
+{
+  auto it = find(aName);
+  if (it == end()) {
+    throw std::out_of_range("No parameter named " + std::string(aName));
+  }
+  return it->second;
+}
+
+inline std::string_view ParamsMap::operator[](std::string_view aName) const
+{
+  auto it = find(aName);
+  return it == end() ? std::string_view{} : it->second;
+}
+
+template<typename T>
+T
+ParamsMap::sParse(std::string_view aName, std::string_view aValue)
+{
+  try {
+    return ParseValue<T>(aValue);
+  } catch (const ParserError& e) {
+    throw ParserError("Parameter " + std::string(aName) + ": " + e.what());
+  }
+}
+
+inline void
+ParamsMap::mClear()
+{
+  mItems.clear();
+  mIds.clear();
+  mDecoded.clear();
+  mDecodedData = mDecoded.data();
+}
+
+inline void
+ParamsMap::mPush(std::string_view aName, std::string_view aValue)
+{
+  mItems.emplace_back(aName, aValue);
+}
+
+inline void
+ParamsMap::mPushDecoded(std::string_view aName, size_t aOffset)
+{
+  if (mDecoded.data() != mDecodedData) {
+    // The appends moved the buffer under the previously decoded values.
+    mRebase(mDecodedData, aOffset);
+  }
+  mItems.emplace_back(
+    aName,
+    std::string_view(mDecoded.data() + aOffset, mDecoded.size() - aOffset));
+}
+
+inline void
+ParamsMap::mRebase(const char* aOldData, size_t aOldSize)
+{
+  std::less_equal<const char*> le;
+  std::less<const char*>       lt;
+  for (auto& item : mItems) {
+    auto data = item.second.data();
+    if (le(aOldData, data) && lt(data, aOldData + aOldSize)) {
+      item.second = std::string_view(mDecoded.data() + (data - aOldData),
+                                     item.second.size());
+    }
+  }
+  mDecodedData = mDecoded.data();
+}
+
+inline EventBatch::EventBatch(size_t aCapacity)
+  : mCapacity(aCapacity)
+{
+  mTypes.reserve(aCapacity);
+  mNames.reserve(aCapacity);
+  mValues.reserve(aCapacity);
+  mDepths.reserve(aCapacity);
+  mAttributeOffsets.reserve(aCapacity + 1);
+  mAttributeOffsets.push_back(0);
+}
+
+inline void
+EventBatch::mClear()
+{
+  mTypes.clear();
+  mNames.clear();
+  mValues.clear();
+  mDepths.clear();
+  mAttributeOffsets.resize(1);
+  mAttributes.clear();
+  mBlock = 0;
+  mUsed  = 0;
+}
+
+inline std::string_view
+EventBatch::mKeep(std::string_view aText, bool aCopy)
+{
+  if (!aCopy || aText.empty()) {
+    return aText;
+  }
+  while (mBlock < mBlocks.size() &&
+         mBlocks[mBlock].second - mUsed < aText.size()) {
+    ++mBlock;
+    mUsed = 0;
+  }
+  if (mBlock == mBlocks.size()) {
+    size_t size = std::max(BLOCK_SIZE, aText.size());
+    mBlocks.emplace_back(std::make_unique<char[]>(size), size);
+  }
+  char* text = mBlocks[mBlock].first.get() + mUsed;
+  memcpy(text, aText.data(), aText.size());
+  mUsed += aText.size();
+  return std::string_view(text, aText.size());
+}
+
+inline void
+Parser::mSetValue(const char* aBegin, const char* aEnd)
+{
+  mView       = std::string_view(aBegin, aEnd - aBegin);
+  mValueOwned = false;
+  mHasEscapes = false;
+}
+
+inline void
+Parser::mError(const std::string& aMessage)
+{
+  if (mCode == mEnd) {
+    if (mMoreInput()) {
+      throw NeedMore{};
+    }
+  } else if (*mCode == 0) {
+    throw ParserError("Unexpected NUL char in the input");
+  }
+  throw ParserError(aMessage);
+}
+
+inline char
+Parser::mPeek(size_t aOffset)
+{
+  if (size_t(mEnd - mCode) <= aOffset) {
+    if (mMoreInput()) {
+      throw NeedMore{};
+    }
+    return 0;
+  }
+  return mCode[aOffset];
+}
+
+inline void
+Parser::mLoad()
+{
+  // The loader may reuse the buffer the current chunk is in.
+  mKeepTagNames();
+  std::shared_ptr<std::string> window;
+  size_t                       pending = mEnd - mCode;
+  if (pending) {
+    window = sReuse(mSpareWindow);
+    window->assign(mCode, pending);
+  }
+  // Growing the window geometrically keeps rescanning a long token linear.
+  while (!window || window->size() < 2 * pending) {
+    auto chunk = mLoader();
+    if (!chunk || !*chunk) {
+      mInputEnded = true;
+      break;
+    }
+    if (!window) {
+      mCode  = chunk;
+      mEnd   = chunk + strlen(chunk);
+      mChunk = chunk;
+      return;
+    }
+    window->append(chunk);
+  }
+  mChunk = nullptr;
+  if (window) {
+    mSpareWindow = std::move(mWindow);
+    mWindow      = std::move(window);
+    mCode        = mWindow->data();
+    mEnd         = mCode + mWindow->size();
+  } else {
+    mCode = mEnd = "";
+  }
+}
+
+inline void
+Parser::mKeepTagNames()
+{
+  if (mTagStack.empty()) {
+    return;
+  }
+  size_t total = 0;
+  for (auto name : mTagStack) {
+    total += name.size();
+  }
+  auto names = std::make_shared<std::string>();
+  names->reserve(total);
+  for (auto& name : mTagStack) {
+    auto offset = names->size();
+    names->append(name);
+    name = std::string_view(names->data() + offset, name.size());
+  }
+  mTagNames = std::move(names);
+}
+
+inline void
+Parser::mOwnChunk()
+{
+  if (!mChunk) {
+    return;
+  }
+  auto chunk = std::make_shared<std::string>(mChunk, mEnd);
+  auto move  = [&](std::string_view& aView) {
+    std::less_equal<const char*> le;
+    if (le(mChunk, aView.data()) && le(aView.data() + aView.size(), mEnd)) {
+      aView = std::string_view(chunk->data() + (aView.data() - mChunk),
+                               aView.size());
+    }
+  };
+  move(mView);
+  for (auto& name : mTagStack) {
+    move(name);
+  }
+  for (auto& item : mParams.mItems) {
+    move(item.first);
+    move(item.second);
+  }
+  mCode   = chunk->data() + (mCode - mChunk);
+  mEnd    = chunk->data() + chunk->size();
+  mWindow = std::move(chunk);
+  mChunk  = nullptr;
+}
+
+inline std::shared_ptr<std::string>
+Parser::sReuse(std::shared_ptr<std::string>& aBuffer)
+{
+  if (aBuffer && aBuffer.use_count() == 1) {
+    aBuffer->clear();
+    return std::move(aBuffer);
+  }
+  return std::make_shared<std::string>();
+}
+
+template<typename T>
+T
+ParseValue(std::string_view aText)
+{
+  auto begin = aText.find_first_not_of(Parser::BLANKS);
+  auto text  = aText.substr(std::min(begin, aText.size()));
+  text       = text.substr(0, text.find_last_not_of(Parser::BLANKS) + 1);
+  auto error = [&](const char* aWhat, const std::string& aDetail = {}) {
+    return ParserError(aWhat + ("'" + std::string(aText) + "'") + aDetail);
+  };
+  if constexpr (std::is_same_v<T, bool>) {
+    if (text == "true" || text == "1") {
+      return true;
+    }
+    if (text == "false" || text == "0") {
+      return false;
+    }
+    throw error("Invalid bool ", ": expected true, false, 1 or 0");
+  } else {
+    static_assert(std::is_arithmetic_v<T>,
+                  "Values convert to integers, floating points or bool");
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-' &&
+        text[1] != '+') {
+      text.remove_prefix(1);
+    }
+    T    value{};
+    auto end    = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    auto invalid =
+      std::is_integral_v<T> ? "Invalid integer " : "Invalid number ";
+    auto offset = [&] { return std::to_string(result.ptr - aText.data()); };
+    if (result.ec == std::errc::result_out_of_range) {
+      throw error(std::is_integral_v<T> ? "Out of range integer "
+                                        : "Out of range number ");
+    }
+    if (result.ec != std::errc()) {
+      throw error(invalid, ": expected a digit at offset " + offset());
+    }
+    if (result.ptr != end) {
+      throw error(invalid,
+                  ": unexpected '" + std::string(1, *result.ptr) +
+                    "' at offset " + offset());
+    }
+    return value;
+  }
+}
+
+inline Parser::Parser(const char* aCode, EventMask aEvents)
+  : Parser(aCode, strlen(aCode), aEvents)
+{
+}
+
+inline Parser::Parser(const char* aData, size_t aSize, EventMask aEvents)
+  : mCode(aData)
+  , mEnd(aData + aSize)
+  , mEvents(aEvents)
 {
-  mCode = aCode;
   Next();
 }
 }
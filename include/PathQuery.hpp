@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Parser.hpp"
+#include "charClass.hpp"
+
+namespace xmlpp {
+
+/**
+ * @brief A path expression, matched against the events of a Parser.
+ *
+ * It takes a subset of XPath: absolute paths made of child ("/") and
+ * descendant ("//") steps. A step is a tag name or "*", followed by any
+ * number of predicates: "[@name]", "[@name='value']" or a 1-based position
+ * "[n]" among the siblings passing the step so far. A final "text()" step
+ * selects the texts directly inside the matched tags.
+ *
+ * @code
+ * PathQuery query("//book[@lang='en']/title/text()");
+ * Parser    p(code);
+ * while (query.Next(p)) {
+ *   titles.emplace_back(p.Value());
+ * }
+ * @endcode
+ *
+ * The path is compiled into a set of states per open tag, kept as a bit
+ * mask, so matching costs no allocation. Tags that can not lead to a match
+ * are left with Parser::SkipElement(), without looking at their content.
+ */
+class PathQuery
+{
+public:
+  /**
+   * @brief Compiles the given path.
+   * @throw std::invalid_argument if it is not a valid path.
+   */
+  explicit PathQuery(std::string_view aPath);
+
+  /**
+   * @brief Advances aParser to the next match.
+   *
+   * The parser is left at the matching TAG, or TEXT for a text() path. The
+   * first call starts at its current entity, which must be at the top of a
+   * document. Between calls the match can be read, but the parser must not
+   * be moved.
+   * @return true if a match was found, false if the document ended.
+   * @throw ParserError if the document is invalid.
+   */
+  bool Next(Parser& aParser);
+
+  /**
+   * @brief Forgets the current document, to match the query on another.
+   */
+  void Reset();
+
+private:
+  struct Predicate
+  {
+    std::string mName;
+    std::string mValue;
+    bool        mHasValue = false;
+    // Zero for attribute tests.
+    size_t mPosition = 0;
+    size_t mCounter  = 0;
+  };
+
+  struct Step
+  {
+    // Empty for "*".
+    std::string            mName;
+    bool                   mDescendant = false;
+    bool                   mText       = false;
+    std::vector<Predicate> mPredicates;
+  };
+
+  static constexpr size_t MAX_STEPS = 64;
+
+  std::vector<Step> mSteps;
+  size_t            mCounters = 0;
+  // The states of the content of each open tag, the document's first.
+  std::vector<uint64_t> mStates;
+  // The positional counters of each open tag, mCounters per tag.
+  std::vector<uint32_t> mCounts;
+  bool                  mStarted     = false;
+  bool                  mSkipPending = false;
+
+  bool mMatches(const Step& aStep, const Parser& aParser, size_t aLevel);
+
+  void mOpen(size_t aLevel, uint64_t aStates);
+
+  [[noreturn]] static void sError(std::string_view aPath,
+                                  const std::string& aMessage);
+};
+
+inline PathQuery::PathQuery(std::string_view aPath)
+{
+  size_t i = 0;
+
+  auto peek = [&]() { return i < aPath.size() ? aPath[i] : '\0'; };
+
+  auto name = [&]() {
+    if (!IsNameStart(peek())) {
+      sError(aPath, "Expected a name at " + std::to_string(i));
+    }
+    auto begin = i;
+    while (IsNameChar(peek())) {
+      ++i;
+    }
+    return std::string(aPath.substr(begin, i - begin));
+  };
+
+  auto expect = [&](char aExpected) {
+    if (peek() != aExpected) {
+      sError(aPath,
+             std::string("Expected '") + aExpected + "' at " +
+               std::to_string(i));
+    }
+    ++i;
+  };
+
+  if (peek() != '/') {
+    sError(aPath, "Paths must start with '/'");
+  }
+  while (i < aPath.size()) {
+    if (!mSteps.empty() && mSteps.back().mText) {
+      sError(aPath, "text() must be the last step");
+    }
+    auto& step = mSteps.emplace_back();
+    expect('/');
+    if (peek() == '/') {
+      step.mDescendant = true;
+      ++i;
+    }
+    if (aPath.substr(i, 6) == "text()") {
+      step.mText = true;
+      i += 6;
+      continue;
+    }
+    if (peek() == '*') {
+      ++i;
+    } else {
+      step.mName = name();
+    }
+    while (peek() == '[') {
+      ++i;
+      auto& predicate = step.mPredicates.emplace_back();
+      if (peek() == '@') {
+        ++i;
+        predicate.mName = name();
+        if (peek() == '=') {
+          ++i;
+          auto quote = peek();
+          if (quote != '\'' && quote != '"') {
+            sError(aPath, "Expected a quoted value at " + std::to_string(i));
+          }
+          auto end = aPath.find(quote, ++i);
+          if (end == std::string_view::npos) {
+            sError(aPath, "Unclosed value");
+          }
+          predicate.mValue    = std::string(aPath.substr(i, end - i));
+          predicate.mHasValue = true;
+          i                   = end + 1;
+        }
+      } else {
+        while (peek() >= '0' && peek() <= '9') {
+          predicate.mPosition = predicate.mPosition * 10 + (peek() - '0');
+          ++i;
+        }
+        if (predicate.mPosition == 0) {
+          sError(aPath, "Expected a position from 1 at " + std::to_string(i));
+        }
+        predicate.mCounter = mCounters++;
+      }
+      expect(']');
+    }
+  }
+  if (mSteps.size() > MAX_STEPS) {
+    sError(aPath, "Too many steps");
+  }
+}
+
+inline void
+PathQuery::Reset()
+{
+  mStates.clear();
+  mCounts.clear();
+  mStarted     = false;
+  mSkipPending = false;
+}
+
+inline bool
+PathQuery::Next(Parser& aParser)
+{
+  bool more;
+  if (!mStarted) {
+    mStarted = true;
+    mOpen(0, 1);
+    more = true;
+  } else if (mSkipPending) {
+    more = aParser.SkipElement();
+  } else {
+    more = aParser.Next();
+  }
+  mSkipPending = false;
+  for (; more; more = aParser.Next()) {
+    auto type  = aParser.Type();
+    auto level = aParser.Depth();
+    if (type == EntityType::TAG_ENDING) {
+      if (mStates.size() > level + 1) {
+        mStates.resize(level + 1);
+      }
+      continue;
+    }
+    if (level >= mStates.size()) {
+      // Entered without the query, so nothing inside can match.
+      continue;
+    }
+    auto states = mStates[level];
+    if (type == EntityType::TEXT) {
+      // Empty texts are left out, like the one before a push mode input.
+      if (mSteps.back().mText && (states >> (mSteps.size() - 1) & 1) &&
+          !aParser.RawValue().empty()) {
+        return true;
+      }
+      continue;
+    }
+    if (type == EntityType::COMMENT) {
+      continue;
+    }
+    uint64_t inner   = 0;
+    bool     matched = false;
+    for (size_t k = 0; k < mSteps.size(); ++k) {
+      if (!(states >> k & 1)) {
+        continue;
+      }
+      auto& step = mSteps[k];
+      if (step.mDescendant) {
+        inner |= uint64_t(1) << k;
+      }
+      if (step.mText || !mMatches(step, aParser, level)) {
+        continue;
+      }
+      if (k + 1 == mSteps.size()) {
+        matched = true;
+      } else {
+        inner |= uint64_t(1) << (k + 1);
+      }
+    }
+    mOpen(level + 1, inner);
+    if (matched) {
+      mSkipPending = inner == 0;
+      return true;
+    }
+    if (inner == 0) {
+      more = aParser.SkipElement();
+      if (!more) {
+        break;
+      }
+      mStates.resize(level + 1);
+    }
+  }
+  return false;
+}
+
+inline bool
+PathQuery::mMatches(const Step& aStep, const Parser& aParser, size_t aLevel)
+{
+  if (!aStep.mName.empty() && aStep.mName != aParser.ValueView()) {
+    return false;
+  }
+  for (auto& predicate : aStep.mPredicates) {
+    if (predicate.mPosition) {
+      auto& count = mCounts[aLevel * mCounters + predicate.mCounter];
+      if (++count != predicate.mPosition) {
+        return false;
+      }
+      continue;
+    }
+    auto& params = aParser.Parameters();
+    auto  param  = params.find(predicate.mName);
+    if (param == params.end() ||
+        (predicate.mHasValue && param->second != predicate.mValue)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline void
+PathQuery::mOpen(size_t aLevel, uint64_t aStates)
+{
+  mStates.resize(aLevel);
+  mStates.push_back(aStates);
+  mCounts.resize((aLevel + 1) * mCounters);
+  std::fill(mCounts.begin() + aLevel * mCounters, mCounts.end(), 0);
+}
+
+inline void
+PathQuery::sError(std::string_view aPath, const std::string& aMessage)
+{
+  throw std::invalid_argument("Invalid path '" + std::string(aPath) +
+                              "': " + aMessage);
+}
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Parser.hpp"
+
+namespace xmlpp {
+
+/**
+ * @brief A whole document as a flat array of 64 bit entries.
+ *
+ * Built in one pass over the Parser events, it can then be walked any
+ * number of times without parsing again. Each tag gives a TAG entry,
+ * followed by a PARAM_NAME and a PARAM_VALUE entry per parameter, and later
+ * by its TAG_ENDING entry. Texts and comments give one entry each.
+ *
+ * An entry packs its type, the offset and length of its value in the
+ * source, as it is there, and a flag for values with escapes or CDATA.
+ * Those are also kept decoded in a side pool, indexed apart from the
+ * entries. A TAG entry holds the index of its TAG_ENDING in place of the
+ * length, which is the same for both, so skipping a subtree is O(1).
+ *
+ * The source must outlive the tape, and be smaller than 4 GiB.
+ */
+class Tape
+{
+public:
+  enum EntryType : uint8_t
+  {
+    TAG,         //!< TAG A tag opening, holding its TAG_ENDING's index
+    TAG_ENDING,  //!< TAG_ENDING A tag closing, also given for single tags
+    COMMENT,     //!< COMMENT A comment
+    TEXT,        //!< TEXT A text
+    PARAM_NAME,  //!< PARAM_NAME The name of a tag parameter
+    PARAM_VALUE, //!< PARAM_VALUE The value of the previous PARAM_NAME
+  };
+
+  /**
+   * @brief Parses aSize chars from aData into a tape.
+   * @throw ParserError if the document is invalid.
+   */
+  Tape(const char* aData, size_t aSize);
+
+  /**
+   * @brief Parses a c-string into a tape.
+   */
+  explicit Tape(const char* aCode)
+    : Tape(aCode, strlen(aCode))
+  {
+  }
+
+  size_t size() const { return mEntries.size(); }
+  bool   empty() const { return mEntries.empty(); }
+
+  /**
+   * @brief The raw entries.
+   */
+  const std::vector<uint64_t>& Entries() const { return mEntries; }
+
+  EntryType Type(size_t aIndex) const
+  {
+    return EntryType(mEntries[aIndex] >> TYPE_SHIFT);
+  }
+
+  /**
+   * @brief Returns the tag name, parameter name or value of the entry.
+   *
+   * Escape sequences are already decoded, as in Parser::Value().
+   */
+  std::string_view View(size_t aIndex) const;
+
+  /**
+   * @brief Returns the entry's value as it is in the source.
+   *
+   * For texts escape sequences and CDATA sections are kept as they are, as
+   * in Parser::RawValue(), and for parameter values escape sequences are.
+   */
+  std::string_view RawView(size_t aIndex) const
+  {
+    return std::string_view(mSource + Offset(aIndex), mLength(aIndex));
+  }
+
+  /**
+   * @brief Where the entry's value starts in the source.
+   *
+   * Any region can be parsed again from there, without the whole document.
+   */
+  size_t Offset(size_t aIndex) const { return uint32_t(mEntries[aIndex]); }
+
+  /**
+   * @brief Returns true if the entry's value had escapes or CDATA.
+   */
+  bool Decoded(size_t aIndex) const
+  {
+    return (mEntries[aIndex] >> DECODED_SHIFT) & 1;
+  }
+
+  /**
+   * @brief Returns the index of a TAG's TAG_ENDING.
+   */
+  size_t Ending(size_t aIndex) const
+  {
+    assert(Type(aIndex) == TAG);
+    return mField(aIndex);
+  }
+
+  /**
+   * @brief Returns the index of the entry following aIndex's subtree.
+   *
+   * For a TAG that is past its TAG_ENDING, for a PARAM_NAME past its value.
+   */
+  size_t Skip(size_t aIndex) const
+  {
+    switch (Type(aIndex)) {
+      case TAG:
+        return Ending(aIndex) + 1;
+      case PARAM_NAME:
+        return aIndex + 2;
+      default:
+        return aIndex + 1;
+    }
+  }
+
+private:
+  static constexpr unsigned TYPE_SHIFT    = 61;
+  static constexpr unsigned DECODED_SHIFT = 60;
+  static constexpr unsigned FIELD_SHIFT   = 32;
+  static constexpr uint64_t FIELD_MASK    = (uint64_t(1) << 28) - 1;
+
+  const char*           mSource;
+  size_t                mSize;
+  std::vector<uint64_t> mEntries;
+  std::string           mPool;
+  // The decoded entries, in order, with where their value ends in mPool.
+  std::vector<std::pair<uint32_t, uint32_t>> mDecoded;
+
+  size_t mField(size_t aIndex) const
+  {
+    return (mEntries[aIndex] >> FIELD_SHIFT) & FIELD_MASK;
+  }
+
+  size_t mLength(size_t aIndex) const
+  {
+    return mField(Type(aIndex) == TAG ? Ending(aIndex) : aIndex);
+  }
+
+  void mPush(EntryType        aType,
+             std::string_view aRaw,
+             std::string_view aValue);
+
+  std::string_view mRawParamValue(std::string_view aName) const;
+};
+
+inline Tape::Tape(const char* aData, size_t aSize)
+  : mSource(aData)
+  , mSize(aSize)
+{
+  if (aSize > UINT32_MAX) {
+    throw ParserError("The input is too large for a tape");
+  }
+  std::vector<size_t> open;
+  Parser              parser(aData, aSize);
+  do {
+    auto type = parser.Type();
+    if (type == EntityType::TAG) {
+      open.push_back(mEntries.size());
+      mPush(TAG, parser.RawValue(), parser.RawValue());
+      for (auto& param : parser.Parameters()) {
+        mPush(PARAM_NAME, param.first, param.first);
+        mPush(PARAM_VALUE, mRawParamValue(param.first), param.second);
+      }
+    } else if (type == EntityType::TAG_ENDING) {
+      // The TAG keeps this index instead of the length they share.
+      auto tag = open.back();
+      open.pop_back();
+      mEntries[tag] |= uint64_t(mEntries.size()) << FIELD_SHIFT;
+      mPush(TAG_ENDING, parser.RawValue(), parser.RawValue());
+    } else if (type == EntityType::COMMENT || !parser.ValueView().empty()) {
+      mPush(type == EntityType::COMMENT ? COMMENT : TEXT,
+            parser.RawValue(),
+            parser.ValueView());
+    }
+  } while (parser.Next());
+  if (!open.empty()) {
+    throw ParserError("Unclosed tag at the end of the document");
+  }
+}
+
+inline std::string_view
+Tape::View(size_t aIndex) const
+{
+  if (!Decoded(aIndex)) {
+    return RawView(aIndex);
+  }
+  auto   found = std::lower_bound(
+    mDecoded.begin(), mDecoded.end(), std::make_pair(uint32_t(aIndex), 0u));
+  size_t begin = found == mDecoded.begin() ? 0 : std::prev(found)->second;
+  return std::string_view(mPool).substr(begin, found->second - begin);
+}
+
+inline void
+Tape::mPush(EntryType aType, std::string_view aRaw, std::string_view aValue)
+{
+  if (aRaw.size() > FIELD_MASK || mEntries.size() > FIELD_MASK) {
+    throw ParserError("The document is too large for a tape");
+  }
+  uint64_t entry = uint64_t(aType) << TYPE_SHIFT;
+  entry |= uint64_t(aRaw.data() - mSource);
+  if (aValue.data() != aRaw.data() || aValue.size() != aRaw.size()) {
+    if (mPool.size() + aValue.size() > UINT32_MAX) {
+      throw ParserError("The document is too large for a tape");
+    }
+    entry |= uint64_t(1) << DECODED_SHIFT;
+    mPool.append(aValue);
+    mDecoded.emplace_back(uint32_t(mEntries.size()), uint32_t(mPool.size()));
+  }
+  if (aType != TAG) {
+    entry |= uint64_t(aRaw.size()) << FIELD_SHIFT;
+  }
+  mEntries.push_back(entry);
+}
+
+inline std::string_view
+Tape::mRawParamValue(std::string_view aName) const
+{
+  // The parser checked the syntax, so only the quotes need finding.
+  auto code  = aName.data() + aName.size();
+  auto rest  = std::string_view(code, mSource + mSize - code);
+  auto open  = rest.find_first_of("'\"");
+  auto close = rest.find(rest[open], open + 1);
+  return rest.substr(open + 1, close - open - 1);
+}
+}
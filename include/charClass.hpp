@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace xmlpp {
+
+/**
+ * @brief Classes a char can belong to, as bit flags.
+ */
+enum class CharClass : uint8_t
+{
+  NONE       = 0,      //!< NONE belongs to no class
+  BLANK      = 1 << 0, //!< BLANK space, tab, carriage return and line feed
+  NAME_START = 1 << 1, //!< NAME_START may start a tag or parameter name
+  NAME_CHAR  = 1 << 2, //!< NAME_CHAR may continue a tag or parameter name
+  QUOTE      = 1 << 3, //!< QUOTE may delimit a parameter value
+  MARKUP     = 1 << 4, //!< MARKUP delimits tags, parameters and escapes
+};
+
+constexpr CharClass
+operator|(CharClass aLeft, CharClass aRight)
+{
+  return CharClass(uint8_t(aLeft) | uint8_t(aRight));
+}
+
+constexpr CharClass
+operator&(CharClass aLeft, CharClass aRight)
+{
+  return CharClass(uint8_t(aLeft) & uint8_t(aRight));
+}
+
+/**
+ * @brief The class of each of the 256 char values.
+ *
+ * Bytes from 0x80 on are accepted as name chars, so UTF-8 names work
+ * without decoding them.
+ */
+inline constexpr std::array<CharClass, 256> CHAR_CLASSES = [] {
+  constexpr auto NAME = CharClass::NAME_START | CharClass::NAME_CHAR;
+  std::array<CharClass, 256> table{};
+  for (unsigned c = 'a'; c <= 'z'; ++c) {
+    table[c] = NAME;
+  }
+  for (unsigned c = 'A'; c <= 'Z'; ++c) {
+    table[c] = NAME;
+  }
+  for (unsigned c = '0'; c <= '9'; ++c) {
+    table[c] = CharClass::NAME_CHAR;
+  }
+  for (unsigned c = 0x80; c <= 0xff; ++c) {
+    table[c] = NAME;
+  }
+  table['_'] = table[':'] = NAME;
+  table['-'] = table['.'] = CharClass::NAME_CHAR;
+  table[' '] = table['\t'] = table['\n'] = table['\r'] = CharClass::BLANK;
+  table['"'] = table['\''] = CharClass::QUOTE;
+  table['<'] = table['>'] = table['/'] = table['='] = CharClass::MARKUP;
+  table['?'] = table['&'] = CharClass::MARKUP;
+  return table;
+}();
+
+/**
+ * @brief Checks if aChar belongs to any of the given classes.
+ */
+constexpr bool
+IsCharClass(char aChar, CharClass aClasses)
+{
+  return (CHAR_CLASSES[uint8_t(aChar)] & aClasses) != CharClass::NONE;
+}
+
+constexpr bool
+IsBlank(char aChar)
+{
+  return IsCharClass(aChar, CharClass::BLANK);
+}
+
+constexpr bool
+IsNameStart(char aChar)
+{
+  return IsCharClass(aChar, CharClass::NAME_START);
+}
+
+constexpr bool
+IsNameChar(char aChar)
+{
+  return IsCharClass(aChar, CharClass::NAME_CHAR);
+}
+
+constexpr bool
+IsQuote(char aChar)
+{
+  return IsCharClass(aChar, CharClass::QUOTE);
+}
+
+constexpr bool
+IsMarkup(char aChar)
+{
+  return IsCharClass(aChar, CharClass::MARKUP);
+}
+
+/**
+ * @brief The value of a decimal digit, or -1 if aChar is not one.
+ *
+ * Unlike isdigit() it does not depend on the locale.
+ */
+constexpr int
+DecimalDigitValue(char aChar)
+{
+  return (aChar >= '0' && aChar <= '9') ? aChar - '0' : -1;
+}
+
+/**
+ * @brief The value of a hexadecimal digit, or -1 if aChar is not one.
+ */
+constexpr int
+HexDigitValue(char aChar)
+{
+  if (aChar >= 'a' && aChar <= 'f') {
+    return aChar - 'a' + 10;
+  }
+  if (aChar >= 'A' && aChar <= 'F') {
+    return aChar - 'A' + 10;
+  }
+  return DecimalDigitValue(aChar);
+}
+}
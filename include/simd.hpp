@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XMLPP_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define XMLPP_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// The aligned loads may touch bytes around the buffer, never across a page.
+#if defined(__GNUC__) || defined(__clang__)
+#define XMLPP_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define XMLPP_NO_SANITIZE_ADDRESS
+#endif
+
+namespace xmlpp {
+
+/**
+ * @brief Finds the first aFirst, aSecond or NUL char in [aBegin, aEnd).
+ *
+ * It uses SSE2 when available, and AVX2 if the running CPU has it, falling
+ * back to a plain loop otherwise. Loads are aligned and each one holds at
+ * least a byte of the range, so it never reads across a page boundary and
+ * the range needs no terminator.
+ *
+ * @return a pointer to the found char, or aEnd if there is none.
+ */
+const char* ScanUntil(const char* aBegin,
+                      const char* aEnd,
+                      char        aFirst,
+                      char        aSecond);
+
+namespace simd {
+
+inline unsigned
+CountTrailingZeros(uint32_t aMask)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, aMask);
+  return unsigned(index);
+#else
+  return unsigned(__builtin_ctz(aMask));
+#endif
+}
+
+inline const char*
+ScanUntilScalar(const char* aBegin,
+                const char* aEnd,
+                char        aFirst,
+                char        aSecond)
+{
+  while (aBegin != aEnd && *aBegin != aFirst && *aBegin != aSecond &&
+         *aBegin != 0) {
+    ++aBegin;
+  }
+  return aBegin;
+}
+
+#ifdef XMLPP_SSE2
+XMLPP_NO_SANITIZE_ADDRESS inline const char*
+ScanUntilSse2(const char* aBegin, const char* aEnd, char aFirst, char aSecond)
+{
+  if (aBegin == aEnd) {
+    return aEnd;
+  }
+  const __m128i first  = _mm_set1_epi8(aFirst);
+  const __m128i second = _mm_set1_epi8(aSecond);
+  const __m128i zero   = _mm_setzero_si128();
+
+  auto offset = unsigned(reinterpret_cast<uintptr_t>(aBegin) & 15);
+  auto block  = reinterpret_cast<const __m128i*>(aBegin - offset);
+  for (uint32_t mask = ~0u << offset;; mask = ~0u) {
+    __m128i chunk = _mm_load_si128(block);
+    __m128i found = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, first), _mm_cmpeq_epi8(chunk, second)),
+      _mm_cmpeq_epi8(chunk, zero));
+    mask &= uint32_t(_mm_movemask_epi8(found));
+    auto position = reinterpret_cast<const char*>(block);
+    if (mask) {
+      position += CountTrailingZeros(mask);
+      return position < aEnd ? position : aEnd;
+    }
+    if (aEnd - position <= 16) {
+      return aEnd;
+    }
+    ++block;
+  }
+}
+#endif
+
+#ifdef XMLPP_AVX2
+__attribute__((target("avx2"))) XMLPP_NO_SANITIZE_ADDRESS inline const char*
+ScanUntilAvx2(const char* aBegin, const char* aEnd, char aFirst, char aSecond)
+{
+  if (aBegin == aEnd) {
+    return aEnd;
+  }
+  const __m256i first  = _mm256_set1_epi8(aFirst);
+  const __m256i second = _mm256_set1_epi8(aSecond);
+  const __m256i zero   = _mm256_setzero_si256();
+
+  auto offset = unsigned(reinterpret_cast<uintptr_t>(aBegin) & 31);
+  auto block  = reinterpret_cast<const __m256i*>(aBegin - offset);
+  for (uint32_t mask = ~0u << offset;; mask = ~0u) {
+    __m256i chunk = _mm256_load_si256(block);
+    __m256i found =
+      _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, first),
+                                      _mm256_cmpeq_epi8(chunk, second)),
+                      _mm256_cmpeq_epi8(chunk, zero));
+    mask &= uint32_t(_mm256_movemask_epi8(found));
+    auto position = reinterpret_cast<const char*>(block);
+    if (mask) {
+      position += CountTrailingZeros(mask);
+      return position < aEnd ? position : aEnd;
+    }
+    if (aEnd - position <= 32) {
+      return aEnd;
+    }
+    ++block;
+  }
+}
+#endif
+
+using ScanUntilFunction = const char* (*)(const char*,
+                                          const char*,
+                                          char,
+                                          char);
+
+inline ScanUntilFunction
+SelectScanUntil()
+{
+#ifdef XMLPP_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return ScanUntilAvx2;
+  }
+#endif
+#ifdef XMLPP_SSE2
+  return ScanUntilSse2;
+#else
+  return ScanUntilScalar;
+#endif
+}
+} // namespace simd
+
+inline const char*
+ScanUntil(const char* aBegin, const char* aEnd, char aFirst, char aSecond)
+{
+  static const simd::ScanUntilFunction scan = simd::SelectScanUntil();
+  return scan(aBegin, aEnd, aFirst, aSecond);
+}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+namespace xmlpp {
+
+/**
+ * @brief The greatest number of bytes EncodeUtf8() writes.
+ */
+constexpr size_t UTF8_MAX_BYTES = 4;
+
+/**
+ * @brief Encodes a code point as UTF-8, independently of the locale.
+ *
+ * @param aCodePoint the code point.
+ * @param aOut where to write, must have room for UTF8_MAX_BYTES.
+ * @return the number of bytes written, or 0 if aCodePoint is a surrogate
+ * or is beyond 0x10FFFF, in which case nothing is written.
+ */
+constexpr size_t
+EncodeUtf8(char32_t aCodePoint, char* aOut)
+{
+  if (aCodePoint < 0x80) {
+    aOut[0] = char(aCodePoint);
+    return 1;
+  }
+  if (aCodePoint < 0x800) {
+    aOut[0] = char(0xC0 | (aCodePoint >> 6));
+    aOut[1] = char(0x80 | (aCodePoint & 0x3F));
+    return 2;
+  }
+  if (aCodePoint < 0x10000) {
+    if (aCodePoint >= 0xD800 && aCodePoint <= 0xDFFF) {
+      return 0;
+    }
+    aOut[0] = char(0xE0 | (aCodePoint >> 12));
+    aOut[1] = char(0x80 | ((aCodePoint >> 6) & 0x3F));
+    aOut[2] = char(0x80 | (aCodePoint & 0x3F));
+    return 3;
+  }
+  if (aCodePoint <= 0x10FFFF) {
+    aOut[0] = char(0xF0 | (aCodePoint >> 18));
+    aOut[1] = char(0x80 | ((aCodePoint >> 12) & 0x3F));
+    aOut[2] = char(0x80 | ((aCodePoint >> 6) & 0x3F));
+    aOut[3] = char(0x80 | (aCodePoint & 0x3F));
+    return 4;
+  }
+  return 0;
+}
+}
@@ -0,0 +1,148 @@
+#include "Binding.hpp"
+#include <string>
+#include <vector>
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+namespace {
+struct Point
+{
+  int    x = 0;
+  double y = 0;
+  string label;
+  bool   visible = false;
+};
+
+struct Shape
+{
+  string         name;
+  unsigned       id = 0;
+  vector<Point>  points;
+  Point          center;
+  vector<string> tags;
+};
+
+// Pairs of names with the same hash.
+struct Collisions
+{
+  int    costarring = 0;
+  int    liquid     = 0;
+  int    altarage   = 0;
+  string declinate;
+  string macallums;
+};
+}
+
+template<>
+struct xmlpp::Binding<Point>
+{
+  static constexpr auto FIELDS =
+    std::make_tuple(AttributeField("x", &Point::x),
+                    AttributeField("visible", &Point::visible),
+                    ChildField("y", &Point::y),
+                    ChildField("label", &Point::label));
+};
+
+template<>
+struct xmlpp::Binding<Shape>
+{
+  static constexpr auto FIELDS =
+    std::make_tuple(AttributeField("name", &Shape::name),
+                    AttributeField("id", &Shape::id),
+                    ChildField("point", &Shape::points),
+                    ChildField("center", &Shape::center),
+                    ChildField("tag", &Shape::tags));
+};
+
+template<>
+struct xmlpp::Binding<Collisions>
+{
+  static constexpr auto FIELDS =
+    std::make_tuple(AttributeField("costarring", &Collisions::costarring),
+                    AttributeField("liquid", &Collisions::liquid),
+                    AttributeField("altarage", &Collisions::altarage),
+                    ChildField("declinate", &Collisions::declinate),
+                    ChildField("macallums", &Collisions::macallums));
+};
+
+TEST_CASE("Binding fields", "[xmlpp][binding]")
+{
+  auto point = Bind<Point>("<point x='-4' visible='true'><y> 2.5 </y>"
+                           "<label>a &amp; <![CDATA[<b>]]></label></point>");
+  CHECK(point.x == -4);
+  CHECK(point.y == 2.5);
+  CHECK(point.label == "a & <b>");
+  CHECK(point.visible);
+
+  // Missing fields keep their values, unknown ones are skipped.
+  auto other = Bind<Point>("<?xml version='1.0'?><!-- c --><point other='1'>"
+                           "<unknown><y>7</y></unknown><label/></point>");
+  CHECK(other.x == 0);
+  CHECK(other.y == 0);
+  CHECK(other.label.empty());
+  CHECK_FALSE(other.visible);
+}
+
+TEST_CASE("Binding nested structs", "[xmlpp][binding]")
+{
+  auto shape = Bind<Shape>("<shape name='tri' id='12'>"
+                           "<point x='1'><y>1.5</y></point>"
+                           "<junk><point x='99'/></junk>"
+                           "<tag>a</tag><point x='2' visible='0'/>"
+                           "<center x='3'><label>c<!-- x -->d</label></center>"
+                           "<tag>b</tag></shape>");
+  CHECK(shape.name == "tri");
+  CHECK(shape.id == 12);
+  REQUIRE(shape.points.size() == 2);
+  CHECK(shape.points[0].x == 1);
+  CHECK(shape.points[0].y == 1.5);
+  CHECK(shape.points[1].x == 2);
+  CHECK(shape.center.x == 3);
+  CHECK(shape.center.label == "cd");
+  CHECK(shape.tags == vector<string>({"a", "b"}));
+
+  // The parser is left at the bound tag's ending.
+  Parser p("<list><point x='5'/><shape/></list>");
+  p.Next();
+  Point point;
+  Bind(p, point);
+  CHECK(point.x == 5);
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  CHECK(p.Value() == "point");
+  REQUIRE(p.Next());
+  CHECK(p.Value() == "shape");
+}
+
+TEST_CASE("Binding hash collisions", "[xmlpp][binding]")
+{
+  static_assert(binding::NameHash("costarring") ==
+                binding::NameHash("liquid"));
+  static_assert(binding::NameHash("declinate") ==
+                binding::NameHash("macallums"));
+  static_assert(binding::NameHash("altarage") == binding::NameHash("zinke"));
+  auto value = Bind<Collisions>(
+    "<c liquid='2' costarring='1' zinke='3'>"
+    "<macallums>m</macallums><declinate>d</declinate></c>");
+  CHECK(value.costarring == 1);
+  CHECK(value.liquid == 2);
+  CHECK(value.altarage == 0);
+  CHECK(value.declinate == "d");
+  CHECK(value.macallums == "m");
+}
+
+TEST_CASE("Binding errors", "[xmlpp][binding][error]")
+{
+  CHECK_THROWS_AS(Bind<Point>("<point x='1.5'/>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("<point x=''/>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("<point visible='yes'/>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("<point><y>1x</y></point>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("<point><y/></point>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("<point><y>1<b/>2</y></point>"), ParserError);
+  CHECK_THROWS_AS(Bind<Shape>("<shape id='-1'/>"), ParserError);
+  CHECK_THROWS_AS(Bind<Shape>("<shape id='99999999999'/>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("<point><y>1</y>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("<point></other>"), ParserError);
+  CHECK_THROWS_AS(Bind<Point>("no tags"), ParserError);
+}
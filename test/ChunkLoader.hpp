@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief A Parser loader giving a document in chunks of a fixed size.
+ *
+ * Like a loader reading a stream, it overwrites a single buffer on every
+ * call. mPosition is how much of the document was given so far, and can be
+ * set back to give it again from there. Pass it with std::ref(), so parsers
+ * and their copies share it.
+ */
+struct ChunkLoader
+{
+  std::string_view mDocument;
+  size_t           mSize;
+  size_t           mPosition = 0;
+  std::string      mBuffer;
+
+  ChunkLoader(std::string_view aDocument, size_t aSize)
+    : mDocument(aDocument)
+    , mSize(aSize)
+  {
+  }
+
+  const char* operator()()
+  {
+    mBuffer.assign(mDocument.substr(mPosition, mSize));
+    mPosition += mBuffer.size();
+    return mBuffer.c_str();
+  }
+};
@@ -0,0 +1,104 @@
+#include "Document.hpp"
+#include <string>
+#include <vector>
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+TEST_CASE("Document tree", "[xmlpp][document]")
+{
+  const string document = "<!--head--><root a='1' b='x&amp;y'><leaf/>"
+                          "some &lt;text<branch><x>y</x></branch></root>";
+  Document doc(document.data(), document.size());
+  REQUIRE(doc.size() == 7);
+  auto root = doc.Root();
+  REQUIRE(root);
+  CHECK(root->Name() == "root");
+  CHECK(root->Parent() == nullptr);
+  CHECK(root->Parameter("a") == "1");
+  CHECK(root->Parameter("b") == "x&y");
+  CHECK(root->Parameter("c").empty());
+  CHECK(root->Parameters().size() == 2);
+  CHECK(root->SubtreeSize() == 6);
+
+  vector<string> children;
+  for (auto& child : root->Children()) {
+    children.emplace_back(child.Value());
+    CHECK(child.Parent() == root);
+  }
+  CHECK(children == vector<string>({"leaf", "some <text", "branch"}));
+
+  auto branch = root->FirstChild()->NextSibling()->NextSibling();
+  CHECK(branch->Name() == "branch");
+  CHECK(branch->NextSibling() == nullptr);
+  CHECK(branch->FirstChild()->Name() == "x");
+  CHECK(branch->FirstChild()->FirstChild()->Value() == "y");
+  CHECK(branch->FirstChild()->FirstChild()->Name().empty());
+  CHECK(root->FirstChild()->FirstChild() == nullptr);
+
+  // Nodes are in document order, and plain values point into the source.
+  vector<string> values;
+  for (auto& node : doc) {
+    values.emplace_back(node.Value());
+  }
+  CHECK(values == vector<string>({"head", "root", "leaf", "some <text",
+                                  "branch", "x", "y"}));
+  CHECK(doc.begin()->Type() == EntityType::COMMENT);
+  CHECK(root->Name().data() == document.data() + 12);
+  CHECK(root->Parameter("a").data() == document.data() + 20);
+}
+
+TEST_CASE("Document top level", "[xmlpp][document]")
+{
+  Document doc("<?xml version='1.0'?><!--a--><root/><!--b-->");
+  vector<string> values;
+  for (auto& node : doc.Children()) {
+    values.emplace_back(node.Value());
+  }
+  CHECK(values == vector<string>({"a", "root", "b"}));
+  CHECK(doc.Root()->Name() == "root");
+  CHECK(Document("").Root() == nullptr);
+  CHECK(Document("").Children().empty());
+  CHECK(Document("<!--c-->").Root() == nullptr);
+  CHECK_THROWS_AS(Document("<root>"), ParserError);
+  CHECK_THROWS_AS(Document("<root></toor>"), ParserError);
+}
+
+TEST_CASE("Document moves", "[xmlpp][document]")
+{
+  string source = "<list>";
+  for (int i = 0; i < 1000; ++i) {
+    source += "<item id='" + to_string(i) + "'>&lt;" + to_string(i) +
+              "</item>";
+  }
+  source += "</list>";
+  vector<Document> docs;
+  docs.emplace_back(source.c_str());
+  docs.emplace_back(source.c_str());
+  size_t count = 0;
+  for (auto& item : docs[0].Root()->Children()) {
+    REQUIRE(item.Parameter("id") == to_string(count));
+    REQUIRE(item.FirstChild()->Value() == "<" + to_string(count));
+    ++count;
+  }
+  CHECK(count == 1000);
+}
+
+TEST_CASE("Document grows its nodes", "[xmlpp][document]")
+{
+  // Far more nodes than first reserved, and a text far larger than them.
+  string source = "<list>";
+  for (int i = 0; i < 10000; ++i) {
+    source += "<item/>";
+  }
+  source += "<text>" + string(size_t(8) << 20, 'x') + "</text></list>";
+  Document doc(source.c_str());
+  CHECK(doc.size() == 10003);
+  size_t count = 0;
+  for (auto& item : doc.Root()->Children()) {
+    count += item.Name() == "item";
+  }
+  CHECK(count == 10000);
+  CHECK(doc.end()[-1].Value().size() == size_t(8) << 20);
+}
@@ -0,0 +1,132 @@
+#include "EventStream.hpp"
+#include <deque>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+using namespace xmlpp;
+using namespace std;
+
+namespace {
+// Resumes the coroutines waiting for input, one chunk at a time.
+struct EventLoop
+{
+  deque<coroutine_handle<>> mReady;
+
+  void Run()
+  {
+    while (!mReady.empty()) {
+      auto handle = mReady.front();
+      mReady.pop_front();
+      handle.resume();
+    }
+  }
+};
+
+// Gives aChunk-sized pieces of aDocument, each after a trip through aLoop.
+struct Source
+{
+  EventLoop* mLoop;
+  string     mDocument;
+  size_t     mChunk;
+  size_t     mPosition = 0;
+
+  auto operator()()
+  {
+    struct Awaiter
+    {
+      Source* mSource;
+
+      bool await_ready() const noexcept { return false; }
+
+      void await_suspend(coroutine_handle<> aHandle)
+      {
+        mSource->mLoop->mReady.push_back(aHandle);
+      }
+
+      string_view await_resume()
+      {
+        auto chunk = string_view(mSource->mDocument)
+                       .substr(mSource->mPosition, mSource->mChunk);
+        mSource->mPosition += chunk.size();
+        return chunk;
+      }
+    };
+    return Awaiter{this};
+  }
+};
+
+// A coroutine started right away and never awaited.
+struct Task
+{
+  struct promise_type
+  {
+    Task              get_return_object() { return {}; }
+    suspend_never     initial_suspend() noexcept { return {}; }
+    suspend_never     final_suspend() noexcept { return {}; }
+    void              return_void() {}
+    [[noreturn]] void unhandled_exception() { terminate(); }
+  };
+};
+
+Task
+Consume(EventStream aEvents, vector<string>& aValues, bool& aFailed)
+{
+  try {
+    while (co_await aEvents.Next()) {
+      aValues.emplace_back(aEvents.Current().ValueView());
+    }
+  } catch (const ParserError&) {
+    aFailed = true;
+  }
+}
+}
+
+TEST_CASE("Event stream", "[xmlpp][coroutine]")
+{
+  const string document =
+    "<root a='1'>some &amp; text<!--c--><leaf/></root>";
+  const vector<string> expected = {
+    "root", "some & text", "c", "leaf", "leaf", "root"};
+  EventLoop loop;
+  for (size_t chunk = 1; chunk <= document.size(); ++chunk) {
+    vector<string> values;
+    bool           failed = false;
+    Consume(ParseEvents(Source{&loop, document, chunk}), values, failed);
+    loop.Run();
+    CHECK_FALSE(failed);
+    REQUIRE(values == expected);
+  }
+}
+
+TEST_CASE("Event stream errors", "[xmlpp][coroutine][error]")
+{
+  EventLoop      loop;
+  vector<string> values;
+  bool           failed = false;
+  Consume(ParseEvents(Source{&loop, "<root>text</toor>", 4}), values, failed);
+  loop.Run();
+  CHECK(failed);
+  CHECK(values == vector<string>({"root", "text"}));
+}
+
+TEST_CASE("Interleaved event streams", "[xmlpp][coroutine]")
+{
+  EventLoop              loop;
+  vector<vector<string>> values(100);
+  bool                   failed = false;
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto document = "<doc" + to_string(i) + ">text</doc" + to_string(i) + ">";
+    Consume(ParseEvents(Source{&loop, document, i % 7 + 1}), values[i], failed);
+  }
+  loop.Run();
+  CHECK_FALSE(failed);
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto name = "doc" + to_string(i);
+    REQUIRE(values[i] == vector<string>({name, "text", name}));
+  }
+}
+
+#endif
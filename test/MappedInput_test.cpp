@@ -0,0 +1,69 @@
+#include "MappedInput.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+#include "Parser.hpp"
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+namespace {
+// Unique across processes, so test runs in parallel do not collide.
+string
+UniqueTempPath()
+{
+  static random_device random;
+  static unsigned      count = 0;
+  auto name = "xmlpp_test_" + to_string(random()) + "_" + to_string(++count);
+  return (filesystem::temp_directory_path() / (name + ".xml")).string();
+}
+
+struct TempFile
+{
+  string mPath;
+
+  TempFile(const string& aContent)
+    : mPath(UniqueTempPath())
+  {
+    ofstream(mPath, ios::binary) << aContent;
+  }
+
+  ~TempFile() { remove(mPath.c_str()); }
+};
+}
+
+TEST_CASE("MappedInput", "[xmlpp][mappedinput]")
+{
+  TempFile file("<root>text</root>");
+  MappedInput input(file.mPath.c_str());
+  REQUIRE(input.Size() == 17);
+  CHECK(input.View() == "<root>text</root>");
+  CHECK_THROWS_AS(MappedInput("/nonexistent/xmlpp.xml"), system_error);
+  SECTION("Empty file")
+  {
+    TempFile    empty("");
+    MappedInput input(empty.mPath.c_str());
+    CHECK(input.Size() == 0);
+    CHECK(input.View().empty());
+  }
+}
+
+TEST_CASE("Parser::FromFile", "[xmlpp][parser][mappedinput]")
+{
+  // Sizes around the page size, where the mapping ends with the file.
+  for (size_t size : {4095, 4096, 4097, 8192}) {
+    string text(size - 13, 'x');
+    TempFile file("<root>" + text + "</root>");
+    auto     p = Parser::FromFile(file.mPath.c_str());
+    REQUIRE(p.Value() == "root");
+    REQUIRE(p.Next());
+    REQUIRE(p.ValueView() == text);
+    REQUIRE(p.Next());
+    REQUIRE(p.Type() == EntityType::TAG_ENDING);
+    REQUIRE_FALSE(p.Next());
+  }
+}
@@ -0,0 +1,63 @@
+#include "NameTable.hpp"
+#include "Parser.hpp"
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+TEST_CASE("NameTable", "[xmlpp][nametable]")
+{
+  NameTable names{"math", "value", "add"};
+  REQUIRE(names.size() == 3);
+  CHECK(names.Find("math") == 1);
+  CHECK(names.Find("value") == 2);
+  CHECK(names.Find("add") == 3);
+  CHECK(names.Find("mul") == NameTable::NO_ID);
+  CHECK(names.Register("mul") == 4);
+  CHECK(names.Register("value") == 2);
+  CHECK(names.Name(4) == "mul");
+  SECTION("Ids stay valid as the table grows")
+  {
+    for (int i = 0; i < 1000; ++i) {
+      names.Register("name" + to_string(i));
+    }
+    CHECK(names.Name(1) == "math");
+    CHECK(names.Find("name999") == 1004);
+    CHECK(names.Find("add") == 3);
+  }
+}
+
+TEST_CASE("Parser name ids", "[xmlpp][parser][nametable]")
+{
+  enum
+  {
+    ROOT = 1,
+    ITEM,
+    ID
+  };
+  NameTable names{"root", "item", "id"};
+  Parser    p("<root><item id='1' other='2'/><new/>text</root>");
+  CHECK(p.NameId() == NameTable::NO_ID);
+  p.Names(&names);
+  CHECK(p.NameId() == ROOT);
+  p.Next();
+  CHECK(p.NameId() == ITEM);
+  auto& params = p.Parameters();
+  CHECK(params.NameId(params.find("id")) == ID);
+  CHECK(params.NameId(params.find("other")) == 4);
+  auto copy = p;
+  CHECK(copy.Parameters().NameId(copy.Parameters().find("other")) == 4);
+  p.Next();
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  CHECK(p.NameId() == ITEM);
+  p.Next();
+  CHECK(p.NameId() == 5);
+  CHECK(names.Name(5) == "new");
+  p.Next();
+  p.Next();
+  CHECK(p.Type() == EntityType::TEXT);
+  CHECK(p.NameId() == NameTable::NO_ID);
+  p.Next();
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  CHECK(p.NameId() == ROOT);
+}
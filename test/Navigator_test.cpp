@@ -0,0 +1,71 @@
+#include "Navigator.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+#include "ChunkLoader.hpp"
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+namespace {
+const char* DOCUMENT = "<?xml version='1.0'?><!--c--><root version='2'>"
+                       "<head id='h1'><title>The &amp; title</title></head>"
+                       "<skip><head id='nested'/><item id='no'/></skip>"
+                       "<item id='1'>one<b>bold</b> more</item>"
+                       "<item id='2'/><other/><item id='3'>three</item>"
+                       "</root>";
+}
+
+TEST_CASE("Navigator chains", "[xmlpp][navigator]")
+{
+  Navigator nav(DOCUMENT);
+  CHECK(nav.Child("root").Attr("version") == "2");
+  CHECK(nav.Child("head").Attr("id") == "h1");
+  CHECK(nav.Child("title").Text() == "The & title");
+  CHECK(nav);
+  // The title was read to its end, so it has no more children to visit.
+  CHECK_FALSE(nav.Child("anything"));
+
+  CHECK(Navigator(DOCUMENT).Child("root").Child("head").Child("title"));
+  CHECK_FALSE(Navigator(DOCUMENT).Child("head"));
+  CHECK_FALSE(Navigator(DOCUMENT).Child("root").Child("title"));
+  CHECK(Navigator(DOCUMENT).Child("root").Child("missing").Attr("id").empty());
+  CHECK(Navigator(DOCUMENT).Child("root").Child("item").Attr("id") == "1");
+  CHECK(Navigator(DOCUMENT).Child("root").Child("item").Text() ==
+        "one more");
+}
+
+TEST_CASE("Navigator siblings", "[xmlpp][navigator]")
+{
+  Navigator      nav(DOCUMENT);
+  vector<string> ids;
+  for (nav.Child("root").Child("item"); nav; nav.Next("item")) {
+    ids.emplace_back(nav.Attr("id"));
+  }
+  CHECK(ids == vector<string>({"1", "2", "3"}));
+
+  Navigator texts(DOCUMENT);
+  texts.Child("root").Child("item");
+  CHECK(texts.Text() == "one more");
+  CHECK(texts.Next("item").Text().empty());
+  CHECK(texts.Next("item").Text() == "three");
+  CHECK_FALSE(texts.Next("item"));
+  CHECK_FALSE(Navigator(DOCUMENT).Next("root"));
+}
+
+TEST_CASE("Navigator reads on demand", "[xmlpp][navigator]")
+{
+  string document = "<root><head id='x'/>";
+  for (int i = 0; i < 1000; ++i) {
+    document += "<item>" + to_string(i) + "</item>";
+  }
+  document += "</root>";
+  ChunkLoader loader(document, 8);
+  Parser      parser(ref(loader));
+  Navigator nav(std::move(parser));
+  CHECK(nav.Child("root").Child("head").Attr("id") == "x");
+  CHECK(loader.mPosition < 40);
+  CHECK(nav.Next("item").Text() == "0");
+  CHECK(loader.mPosition < 60);
+}
@@ -0,0 +1,152 @@
+#include "ParallelParse.hpp"
+#include <string>
+#include <vector>
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+namespace {
+string
+Items(int aCount)
+{
+  string document = "<?xml version='1.0'?><root>";
+  for (int i = 0; i < aCount; ++i) {
+    document += "<item id='" + to_string(i) + "'><n>" + to_string(i) +
+                "</n></item>\n";
+  }
+  return document + "</root>\n<!-- done -->";
+}
+
+vector<string>
+Ids(const string& aDocument, size_t aThreads, size_t aMinChunk = 1)
+{
+  return ParallelParse(
+    aDocument.data(),
+    aDocument.size(),
+    [](Parser& p) { return string(p.Parameters()["id"]); },
+    aThreads,
+    aMinChunk);
+}
+
+vector<string>
+Expected(int aCount)
+{
+  vector<string> ids;
+  for (int i = 0; i < aCount; ++i) {
+    ids.push_back(to_string(i));
+  }
+  return ids;
+}
+}
+
+TEST_CASE("ParallelParse keeps the document order", "[xmlpp][parallel]")
+{
+  auto document = Items(200);
+  CHECK(Ids(document, 1) == Expected(200));
+  CHECK(Ids(document, 4) == Expected(200));
+  CHECK(Ids(document, 16) == Expected(200));
+  CHECK(Ids(document, 4, document.size()) == Expected(200));
+
+  auto sums = ParallelParse(
+    document.data(),
+    document.size(),
+    [](Parser& p) {
+      // Reads to the value, leaving the rest of the child to be skipped.
+      while (p.Next() && p.Type() != EntityType::TEXT) {
+      }
+      return p.ValueAs<int>();
+    },
+    4,
+    1);
+  REQUIRE(sums.size() == 200);
+  CHECK(sums[0] == 0);
+  CHECK(sums[199] == 199);
+}
+
+TEST_CASE("ParallelParse splits only at children", "[xmlpp][parallel]")
+{
+  // Nested items are candidates too, so chunks starting there are reread.
+  string document = "<root>";
+  for (int i = 0; i < 100; ++i) {
+    document += "<item id='" + to_string(i) + "'><item id='x'/>" +
+                "<!-- <item id='c'> --><![CDATA[<item id='d'>]]></item>";
+  }
+  document += "</root>";
+  CHECK(Ids(document, 8) == Expected(100));
+
+  // Only the children named like the first one split the document.
+  string mixed = "<root><head id='h'/>";
+  for (int i = 0; i < 50; ++i) {
+    mixed += "<head id='" + to_string(i) + "'/><body id='b'/>";
+  }
+  mixed += "</root>";
+  auto ids = Ids(mixed, 4);
+  REQUIRE(ids.size() == 101);
+  CHECK(ids[0] == "h");
+  CHECK(ids[1] == "0");
+  CHECK(ids[2] == "b");
+  CHECK(ids[100] == "b");
+}
+
+TEST_CASE("ParallelParse falls back to one thread", "[xmlpp][parallel]")
+{
+  // A comment after the root hides where it ends.
+  auto document = Items(50) + "<!-- </root> -->";
+  CHECK(Ids(document, 4) == Expected(50));
+
+  // Nor can a root without its closing tag.
+  string unclosed = "<root><item id='0'/><item id='1'/>";
+  CHECK(Ids(unclosed, 4) == Expected(2));
+
+  CHECK(Ids("<root/>", 4).empty());
+  CHECK(Ids("<root></root>", 4).empty());
+  CHECK(Ids("<root>text</root>", 4).empty());
+}
+
+TEST_CASE("ParallelParse errors", "[xmlpp][parallel]")
+{
+  auto document = Items(100);
+  auto broken   = document;
+  broken.replace(broken.find("</item>", broken.size() / 2), 7, "</itex>");
+  CHECK_THROWS_AS(Ids(broken, 4), ParserError);
+  CHECK_THROWS_AS(Ids(broken, 1), ParserError);
+
+  // A child left open swallows the rest of the root.
+  auto open = document;
+  open.erase(open.find("</item>", open.size() / 2), 7);
+  CHECK_THROWS_AS(Ids(open, 4), ParserError);
+
+  CHECK_THROWS_AS(ParallelParse(
+                    document.data(),
+                    document.size(),
+                    [](Parser& p) {
+                      if (p.Parameters()["id"] == "77") {
+                        throw ParserError("Rejected");
+                      }
+                      return 0;
+                    },
+                    4,
+                    1),
+                  ParserError);
+}
+
+TEST_CASE("ParallelParse rejects a second root", "[xmlpp][parallel]")
+{
+  string children;
+  for (int i = 0; i < 100; ++i) {
+    children += "<item id='" + to_string(i) + "'/>";
+  }
+  // The same name hides the first root's end from the chunks.
+  auto same  = "<root>" + children + "</root><root>" + children + "</root>";
+  auto other = "<root>" + children + "</root><other>" + children + "</other>";
+  for (size_t threads : {1, 4, 16}) {
+    INFO("Threads: " << threads);
+    CHECK_THROWS_WITH(Ids(same, threads),
+                      "Unexpected second root tag: root");
+    CHECK_THROWS_WITH(Ids(other, threads),
+                      "Unexpected second root tag: other");
+    CHECK_THROWS_WITH(Ids("<root/><other><item id='0'/></other>", threads),
+                      "Unexpected second root tag: other");
+  }
+}
@@ -1,5 +1,13 @@
 #include "Parser.hpp"
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "ChunkLoader.hpp"
 #include "catch.hpp"
 
 using namespace xmlpp;
@@ -18,7 +26,11 @@ TEST_CASE("Tags", "[xmlpp][parser][tags]")
 TEST_CASE("Tag Error", "[xmlpp][parser][tags][error]")
 {
   REQUIRE_THROWS_AS(Parser("<root"), ParserError);
-  // TODO: Other invalid chars.
+  REQUIRE_THROWS_AS(Parser("< root/>"), ParserError);
+  REQUIRE_THROWS_AS(Parser("<-root/>"), ParserError);
+  REQUIRE_THROWS_AS(Parser("<root $/>"), ParserError);
+  REQUIRE_THROWS_AS(Parser("<root ='value'/>"), ParserError);
+  REQUIRE_THROWS_AS(Parser("<root param=value/>"), ParserError);
 }
 
 TEST_CASE("Tags with parameters", "[xmlpp][parser][tags]")
@@ -31,6 +43,64 @@ TEST_CASE("Tags with parameters", "[xmlpp][parser][tags]")
   REQUIRE(s.Parameters().at("párêmçï") == "test");
   REQUIRE(s.Parameters().at("param2") == "test's test");
   REQUIRE(s.Parameters().size() == 3);
+  REQUIRE(s.Next());
+  REQUIRE(s.Type() == EntityType::TAG_ENDING);
+  CHECK(s.Parameters().empty());
+}
+
+TEST_CASE("Parameters are reset on each tag", "[xmlpp][parser][tags]")
+{
+  Parser s("<?xml version='1.0'?><root a='1' b='x&amp;y' c='&lt;' e=''>"
+           "<branch d='2'/></root>");
+  REQUIRE(s.Parameters().size() == 4);
+  CHECK(s.Parameters().count("version") == 0);
+  CHECK(s.Parameters().count("e") == 1);
+  CHECK(s.Parameters()["e"].empty());
+  CHECK(s.Parameters()["a"] == "1");
+  CHECK(s.Parameters()["b"] == "x&y");
+  CHECK(s.Parameters()["c"] == "<");
+  CHECK(s.Parameters()["missing"].empty());
+  CHECK_THROWS_AS(s.Parameters().at("missing"), std::out_of_range);
+  auto copy = s;
+  s.Next();
+  REQUIRE(s.Value() == "branch");
+  REQUIRE(s.Parameters().size() == 1);
+  CHECK(s.Parameters().at("d") == "2");
+  CHECK(s.Parameters().count("a") == 0);
+  CHECK(copy.Parameters()["b"] == "x&y");
+  CHECK(copy.Parameters()["c"] == "<");
+  string order;
+  for (auto& param : copy.Parameters()) {
+    order += string(param.first);
+  }
+  CHECK(order == "abce");
+}
+
+TEST_CASE("Parameters move", "[xmlpp][parser][tags]")
+{
+  static_assert(is_nothrow_move_constructible_v<ParamsMap>);
+  static_assert(is_nothrow_move_assignable_v<ParamsMap>);
+  // Short decoded values are moved out of the small string buffer.
+  Parser s("<root a='1' b='x&amp;y' c='&lt;'/>");
+  Parser moved(std::move(s));
+  CHECK(moved.Parameters()["a"] == "1");
+  CHECK(moved.Parameters()["b"] == "x&y");
+  CHECK(moved.Parameters()["c"] == "<");
+
+  ParamsMap params(moved.Parameters());
+  ParamsMap other(std::move(params));
+  CHECK(other["b"] == "x&y");
+  CHECK(params.empty());
+  params = std::move(other);
+  CHECK(params["c"] == "<");
+
+  vector<Parser> parsers;
+  for (int i = 0; i < 20; ++i) {
+    parsers.emplace_back("<root a='&lt;&gt;'/>");
+  }
+  for (auto& parser : parsers) {
+    CHECK(parser.Parameters()["a"] == "<>");
+  }
 }
 
 TEST_CASE("Tags within tags", "[xmlpp][parser][tags]")
@@ -57,6 +127,31 @@ TEST_CASE("Tag closing", "[xmlpp][parser][tags]")
 TEST_CASE("Tags closing mismatch", "[xmlpp][parser][tags]")
 {
   REQUIRE_THROWS_AS(++++Parser("<root></notroot>"), ParserError);
+  REQUIRE_THROWS_AS(++++Parser("<root></roo>"), ParserError);
+  REQUIRE_THROWS_AS(++++Parser("<root></rooted>"), ParserError);
+  REQUIRE_THROWS_AS(Parser("</root>"), ParserError);
+}
+
+TEST_CASE("Deeply nested tags", "[xmlpp][parser][tags]")
+{
+  string code;
+  for (int i = 0; i < 100; ++i) {
+    code += "<level" + to_string(i) + ">";
+  }
+  for (int i = 99; i >= 0; --i) {
+    code += "</level" + to_string(i) + ">";
+  }
+  Parser s(code.c_str());
+  for (int i = 1; i < 100; ++i) {
+    REQUIRE(s.Next());
+    REQUIRE(s.Type() == EntityType::TAG);
+  }
+  for (int i = 99; i >= 0; --i) {
+    REQUIRE(s.Next());
+    REQUIRE(s.Type() == EntityType::TAG_ENDING);
+    REQUIRE(s.Value() == "level" + to_string(i));
+  }
+  REQUIRE_FALSE(s.Next());
 }
 
 TEST_CASE("Comments", "[xmlpp][parser][comments]")
@@ -97,11 +192,232 @@ TEST_CASE("Text with escaping", "[xmlpp][parser][texts]")
     "text's <\"escaped\"> & quoted");
   REQUIRE(Parser("text&#32;with&#x20;spaces").Value() == "text with spaces");
   REQUIRE(Parser("I &lt;3 J&#xF6;rg").Value() == "I <3 Jörg");
+  REQUIRE(Parser("&#246;&#x20AC;&#x1F600;&#x1f600;").Value() == "ö€😀😀");
   REQUIRE(Parser("<![CDATA[<\"Escaped's\">]]>").Value() == "<\"Escaped's\">");
   REQUIRE(Parser("between <![CDATA[<\"Escaped\">]]> text").Value() ==
           "between <\"Escaped\"> text");
 }
 
+TEST_CASE("Invalid character references", "[xmlpp][parser][texts][error]")
+{
+  CHECK_THROWS_AS(Parser("&#;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#x;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#X41;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#12a;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#xG1;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#0;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#xD800;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#x110000;"), ParserError);
+  CHECK_THROWS_AS(Parser("&#x100000000041;"), ParserError);
+}
+
+TEST_CASE("Invalid entities", "[xmlpp][parser][texts][error]")
+{
+  CHECK_THROWS_AS(Parser("&unknown;"), ParserError);
+  CHECK_THROWS_AS(Parser("&lt"), ParserError);
+  CHECK_THROWS_AS(Parser("& lt;"), ParserError);
+  CHECK_THROWS_AS(Parser("&;"), ParserError);
+  CHECK_THROWS_AS(Parser("&Lt;"), ParserError);
+  CHECK_THROWS_AS(Parser("<root p='&nope;'/>"), ParserError);
+  CHECK_THROWS_AS(Parser("<![CDATA[unclosed"), ParserError);
+  // Unknown entities used to be stored in a shared table.
+  CHECK_THROWS_AS(Parser("&unknown;"), ParserError);
+}
+
+TEST_CASE("Long texts", "[xmlpp][parser][texts]")
+{
+  string plain(1000, 'a');
+  string code = "<r>" + plain + "</r>";
+  Parser s(code.c_str());
+  REQUIRE(s.Next());
+  CHECK(s.Value() == plain);
+  for (size_t i = 0; i < 70; ++i) {
+    string code     = string(i, 'b') + "&lt;" + string(i, 'c') +
+                  "<![CDATA[&amp;]]>" + string(70 - i, 'd') + "&#x41;";
+    string expected = string(i, 'b') + "<" + string(i, 'c') + "&amp;" +
+                      string(70 - i, 'd') + "A";
+    REQUIRE(Parser(code.c_str()).Value() == expected);
+  }
+}
+
+TEST_CASE("Value views", "[xmlpp][parser][views]")
+{
+  const char* code = "<root>plain text<!--comment-->esc&amp;aped</root>";
+  Parser      s(code);
+  REQUIRE(s.ValueView() == "root");
+  CHECK(s.ValueView().data() == code + 1);
+  s.Next();
+  REQUIRE(s.ValueView() == "plain text");
+  CHECK(s.ValueView().data() == code + 6);
+  CHECK(s.Value() == "plain text");
+  s.Next();
+  REQUIRE(s.ValueView() == "comment");
+  CHECK(s.ValueView().data() == code + 20);
+  s.Next();
+  REQUIRE(s.ValueView() == "esc&aped");
+  CHECK(s.Value() == "esc&aped");
+  s.Next();
+  REQUIRE(s.Type() == EntityType::TAG_ENDING);
+  REQUIRE(s.ValueView() == "root");
+  CHECK(Parser("<![CDATA[<raw>]]>").ValueView() == "<raw>");
+}
+
+TEST_CASE("Raw values", "[xmlpp][parser][views]")
+{
+  const char* code = "<root>plain<!--c-->a &lt; b<![CDATA[&amp;]]>&amp;</root>";
+  Parser      s(code);
+  CHECK(s.RawValue() == "root");
+  CHECK_FALSE(s.HasEscapes());
+  s.Next();
+  CHECK(s.RawValue() == "plain");
+  CHECK(s.RawValue().data() == s.ValueView().data());
+  CHECK_FALSE(s.HasEscapes());
+  s.Next();
+  CHECK(s.RawValue() == "c");
+  CHECK_FALSE(s.HasEscapes());
+  s.Next();
+  REQUIRE(s.HasEscapes());
+  CHECK(s.RawValue() == "a &lt; b<![CDATA[&amp;]]>&amp;");
+  CHECK(s.RawValue().data() == code + 19);
+  CHECK(s.ValueView() == "a < b&amp;&");
+  CHECK(s.RawValue() == "a &lt; b<![CDATA[&amp;]]>&amp;");
+  CHECK(s.Value() == "a < b&amp;&");
+  s.Next();
+  CHECK(s.Type() == EntityType::TAG_ENDING);
+  CHECK_FALSE(s.HasEscapes());
+  CHECK(s.ValueView() == "root");
+
+  // Each text is decoded on its own, whichever is asked for.
+  Parser t("<a>&lt;x&gt;</a><b>y&amp;</b>");
+  t.Next();
+  CHECK(t.Value() == "<x>");
+  t.Next();
+  t.Next();
+  t.Next();
+  CHECK(t.RawValue() == "y&amp;");
+  CHECK(t.ValueView() == "y&");
+
+  // Escapes are only checked while scanning, never decoded.
+  CHECK_NOTHROW(CheckEntity("amp"));
+  CHECK_NOTHROW(CheckEntity("#x1F600"));
+  CHECK_THROWS_AS(CheckEntity("nbsp"), ParserError);
+  CHECK_THROWS_AS(CheckEntity("#xD800"), ParserError);
+  CHECK_THROWS_AS(CheckEntity("#0"), ParserError);
+  CHECK_THROWS_AS(CheckEntity("#x110000"), ParserError);
+  CHECK_THROWS_AS(CheckEntity("#"), ParserError);
+  CHECK_THROWS_AS(Parser("a &#xD800; b"), ParserError);
+  CHECK_THROWS_AS(Parser("a &nbsp; b"), ParserError);
+}
+
+TEST_CASE("Typed values", "[xmlpp][parser][typed]")
+{
+  CHECK(ParseValue<int>("42") == 42);
+  CHECK(ParseValue<int>(" -7\n") == -7);
+  CHECK(ParseValue<int>("+7") == 7);
+  CHECK(ParseValue<uint8_t>("255") == 255);
+  CHECK(ParseValue<int64_t>("-9223372036854775808") == INT64_MIN);
+  CHECK(ParseValue<double>("2.5e3") == 2500);
+  CHECK(ParseValue<float>("-.5") == -0.5f);
+  CHECK(ParseValue<bool>("true"));
+  CHECK(ParseValue<bool>(" 1 "));
+  CHECK_FALSE(ParseValue<bool>("false"));
+  CHECK_FALSE(ParseValue<bool>("0"));
+
+  Parser p("<v n='12' f='0.25' b='true' bad='1x'>3.75</v>");
+  auto&  params = p.Parameters();
+  CHECK(params.As<int>("n") == 12);
+  CHECK(params.As<double>("f") == 0.25);
+  CHECK(params.As<bool>("b"));
+  CHECK(params.As<int>("missing", -1) == -1);
+  CHECK(params.As<int>("n", -1) == 12);
+  CHECK_THROWS_AS(params.As<int>("missing"), std::out_of_range);
+  CHECK_THROWS_AS(params.As<int>("bad"), ParserError);
+  CHECK_THROWS_AS(params.As<int>("bad", 0), ParserError);
+  p.Next();
+  CHECK(p.ValueAs<double>() == 3.75);
+  CHECK_THROWS_AS(p.ValueAs<int>(), ParserError);
+  Parser escaped("<v>&#x31;<![CDATA[0]]></v>");
+  escaped.Next();
+  CHECK(escaped.ValueAs<int>() == 10);
+}
+
+TEST_CASE("Typed value errors", "[xmlpp][parser][typed][error]")
+{
+  auto message = [](auto aParse) {
+    try {
+      aParse();
+    } catch (const ParserError& e) {
+      return string(e.what());
+    }
+    return string();
+  };
+  CHECK(message([] { ParseValue<int>("12a"); }) ==
+        "Invalid integer '12a': unexpected 'a' at offset 2");
+  CHECK(message([] { ParseValue<int>(" x"); }) ==
+        "Invalid integer ' x': expected a digit at offset 1");
+  CHECK(message([] { ParseValue<int>(""); }) ==
+        "Invalid integer '': expected a digit at offset 0");
+  CHECK(message([] { ParseValue<unsigned>("-1"); }) ==
+        "Invalid integer '-1': expected a digit at offset 0");
+  CHECK(message([] { ParseValue<int8_t>("300"); }) ==
+        "Out of range integer '300'");
+  CHECK(message([] { ParseValue<double>("1e999"); }) ==
+        "Out of range number '1e999'");
+  CHECK(message([] { ParseValue<double>("1.5.2"); }) ==
+        "Invalid number '1.5.2': unexpected '.' at offset 3");
+  CHECK(message([] { ParseValue<int>("1 2"); }) ==
+        "Invalid integer '1 2': unexpected ' ' at offset 1");
+  CHECK(message([] { ParseValue<int>("++1"); }) ==
+        "Invalid integer '++1': expected a digit at offset 0");
+  CHECK(message([] { ParseValue<bool>("yes"); }) ==
+        "Invalid bool 'yes': expected true, false, 1 or 0");
+  CHECK(message([] { Parser("<v n='x'/>").Parameters().As<int>("n"); }) ==
+        "Parameter n: Invalid integer 'x': expected a digit at offset 0");
+}
+
+TEST_CASE("Sized buffers", "[xmlpp][parser][sized]")
+{
+  const char code[] = "<root a='1'>text</root>tail";
+  Parser     s(code, sizeof(code) - 5);
+  REQUIRE(s.Value() == "root");
+  CHECK(s.Parameters()["a"] == "1");
+  REQUIRE(s.Next());
+  CHECK(s.ValueView() == "text");
+  REQUIRE(s.Next());
+  CHECK(s.Type() == EntityType::TAG_ENDING);
+  CHECK_FALSE(s.Next());
+
+  // Nothing past the end is read, terminator or not.
+  string text(100, 'x');
+  Parser t(text.data(), 40);
+  CHECK(t.ValueView() == string(40, 'x'));
+  CHECK_FALSE(t.Next());
+  CHECK(Parser("ab<c/>", 2).ValueView() == "ab");
+  CHECK_FALSE(Parser("", size_t(0)).Next());
+  CHECK_THROWS_AS(Parser("<root/>", 6), ParserError);
+  CHECK_THROWS_AS(Parser("<root a='1'/>", 10), ParserError);
+  CHECK_THROWS_AS(Parser("<!--c-->", 7), ParserError);
+  CHECK_THROWS_AS(Parser("<![CDATA[x]]>", 12), ParserError);
+  CHECK_THROWS_AS(Parser("&amp;", 4), ParserError);
+}
+
+TEST_CASE("Embedded NUL chars", "[xmlpp][parser][sized][error]")
+{
+  auto parse = [](string code) {
+    Parser s(code.data(), code.size());
+    while (s.Next()) {
+    }
+  };
+  CHECK_THROWS_AS(parse(string("te\0xt", 5)), ParserError);
+  CHECK_THROWS_AS(parse(string("<ro\0ot/>", 8)), ParserError);
+  CHECK_THROWS_AS(parse(string("<root a='\0'/>", 13)), ParserError);
+  CHECK_THROWS_AS(parse(string("<root a\0='1'/>", 14)), ParserError);
+  CHECK_THROWS_AS(parse(string("<!--\0-->", 8)), ParserError);
+  CHECK_THROWS_AS(parse(string("<![CDATA[\0]]>", 13)), ParserError);
+  CHECK_THROWS_AS(parse(string("<root/>\0", 8)), ParserError);
+  CHECK_NOTHROW(parse(string("<root/>", 7)));
+}
+
 TEST_CASE("Xml declartion", "[xmlpp][parser][declaration]")
 {
   REQUIRE(Parser("<?xml version='1.0' encoding='UTF-8'?><root/>").Value() ==
@@ -160,3 +476,491 @@ TEST_CASE("Custom Loader", "[xmlpp][parser][custom-loader]")
     CHECK(p.Value() == "root");
   }
 }
+
+namespace {
+struct Event
+{
+  EntityType type;
+  string     value;
+  string     params;
+
+  bool operator==(const Event& rhs) const
+  {
+    return type == rhs.type && value == rhs.value && params == rhs.params;
+  }
+};
+
+vector<Event>
+Collect(Parser& aParser)
+{
+  vector<Event> events;
+  do {
+    string params;
+    for (auto& param : aParser.Parameters()) {
+      params += string(param.first) + "=" + string(param.second) + ";";
+    }
+    events.push_back({aParser.Type(), aParser.Value(), params});
+  } while (aParser.Next());
+  return events;
+}
+}
+
+TEST_CASE("Chunked loader", "[xmlpp][parser][custom-loader]")
+{
+  const string document =
+    "<?xml version='1.1' encoding='UTF-8'?><root attr='a&amp;b' other=\"x\">"
+    "<!-- a comment -- here --><branch/>Some &lt;text&gt; &#x41;"
+    "<![CDATA[<raw>]]> more text<leaf key='value'>leaf text</leaf>"
+    "</root>";
+  Parser        whole(document.c_str());
+  vector<Event> expected = Collect(whole);
+  REQUIRE(expected.size() == 9);
+  for (size_t size = 1; size <= document.size(); ++size) {
+    ChunkLoader loader(document, size);
+    Parser      p(ref(loader));
+    INFO("Chunk size: " << size);
+    REQUIRE(Collect(p) == expected);
+    CHECK(p.Version() == "1.1");
+  }
+}
+
+TEST_CASE("Chunked loader errors", "[xmlpp][parser][custom-loader]")
+{
+  auto load = [](const char* aDocument) {
+    return [aDocument, position = size_t(0)]() mutable -> const char* {
+      static char buffer[2] = {0};
+      buffer[0]             = aDocument[position];
+      position += buffer[0] != 0;
+      return buffer;
+    };
+  };
+  CHECK_THROWS_AS(Collect(*make_unique<Parser>(load("<root></toor>"))),
+                  ParserError);
+  CHECK_THROWS_AS(Collect(*make_unique<Parser>(load("<root attr='x>"))),
+                  ParserError);
+  CHECK_THROWS_AS(Parser(load("<!-- unclosed")), ParserError);
+  auto p = Parser(load("<root>text"));
+  CHECK(p.Next());
+  CHECK(p.Value() == "text");
+  CHECK_FALSE(p.Next());
+}
+
+TEST_CASE("Chunked loader streams", "[xmlpp][parser][custom-loader]")
+{
+  const string item   = "<item id='1'>some text &amp; more</item>";
+  size_t       loaded = 0;
+  size_t       items  = 0;
+  string       buffer;
+  Parser       p([&]() -> const char* {
+    if (loaded > 10000) {
+      return nullptr;
+    }
+    buffer = loaded++ ? item : "<root>";
+    return buffer.c_str();
+  });
+  while (p.Next()) {
+    if (p.Type() == EntityType::TAG) {
+      ++items;
+      REQUIRE(p.Parameters()["id"] == "1");
+      // Only what is needed for the current item was loaded.
+      REQUIRE(loaded <= items + 2);
+    }
+  }
+  CHECK(items == 10000);
+}
+
+TEST_CASE("Chunked loader postfix increment", "[xmlpp][parser][custom-loader]")
+{
+  const string document = "<root><a k='v'>x</a></root>";
+  ChunkLoader loader(document, 15);
+  Parser      p(ref(loader));
+  REQUIRE(p.Next());
+  auto old = p++;
+  CHECK(p.Value() == "x");
+  CHECK(old.Type() == EntityType::TAG);
+  CHECK(old.Value() == "a");
+  CHECK(old.Parameters()["k"] == "v");
+  CHECK(old.Depth() == 1);
+
+  // The copy goes on from its own copy of the chunk, then loads the rest.
+  loader.mPosition = 15;
+  REQUIRE(old.Next());
+  CHECK(old.Type() == EntityType::TEXT);
+  CHECK(old.Value() == "x");
+  REQUIRE(old.Next());
+  CHECK(old.Type() == EntityType::TAG_ENDING);
+  CHECK(old.Value() == "a");
+  REQUIRE(old.Next());
+  CHECK(old.Value() == "root");
+  CHECK(old.Depth() == 0);
+  CHECK_FALSE(old.Next());
+}
+
+TEST_CASE("Push mode", "[xmlpp][parser][push]")
+{
+  const string document =
+    "<?xml version='1.1' encoding='UTF-8'?><root attr='a&amp;b' other=\"x\">"
+    "<!-- a comment -- here --><branch/>Some &lt;text&gt; &#x41;"
+    "<![CDATA[<raw>]]> more text<leaf key='value'>leaf text</leaf>"
+    "</root>";
+  Parser        whole(document.c_str());
+  vector<Event> expected = Collect(whole);
+  auto          drain    = [](Parser& aParser, vector<Event>& aEvents) {
+    while (aParser.Next()) {
+      string params;
+      for (auto& param : aParser.Parameters()) {
+        params += string(param.first) + "=" + string(param.second) + ";";
+      }
+      aEvents.push_back({aParser.Type(), aParser.Value(), params});
+    }
+  };
+  for (size_t size = 1; size <= document.size(); ++size) {
+    INFO("Fragment size: " << size);
+    Parser        p;
+    vector<Event> events;
+    for (size_t position = 0; position < document.size(); position += size) {
+      // The fragment is overwritten once fed.
+      string fragment = document.substr(position, size);
+      p.Feed(fragment.data(), fragment.size());
+      fragment.assign(fragment.size(), '#');
+      drain(p, events);
+      REQUIRE(p.NeedsInput());
+    }
+    p.Finish();
+    drain(p, events);
+    CHECK_FALSE(p.NeedsInput());
+    REQUIRE(events == expected);
+    CHECK(p.Version() == "1.1");
+  }
+}
+
+TEST_CASE("Push mode events", "[xmlpp][parser][push]")
+{
+  Parser p;
+  CHECK_FALSE(p.Next());
+  CHECK(p.NeedsInput());
+  p.Feed("<root><a", 8);
+  REQUIRE(p.Next());
+  CHECK(p.Value() == "root");
+  CHECK_FALSE(p.Next());
+  p.Feed("/>text", 6);
+  REQUIRE(p.Next());
+  CHECK(p.Value() == "a");
+  REQUIRE(p.Next());
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  // The text may go on in the next fragment.
+  CHECK_FALSE(p.Next());
+  CHECK(p.NeedsInput());
+  p.Feed("<", 1);
+  CHECK_FALSE(p.Next());
+  p.Feed("/", 1);
+  REQUIRE(p.Next());
+  CHECK(p.Value() == "text");
+  p.Feed("root>", 5);
+  REQUIRE(p.Next());
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  CHECK(p.Value() == "root");
+  p.Finish();
+  CHECK_FALSE(p.Next());
+  CHECK_FALSE(p.NeedsInput());
+
+  Parser cut;
+  cut.Feed("<root attr='", 12);
+  CHECK_FALSE(cut.Next());
+  cut.Finish();
+  CHECK_THROWS_AS(cut.Next(), ParserError);
+}
+
+TEST_CASE("Push mode streams", "[xmlpp][parser][push]")
+{
+  const string item  = "<item id='1'>some text &amp; more</item>";
+  size_t       items = 0;
+  Parser       p;
+  p.Feed("<root>", 6);
+  for (size_t i = 0; i < 10000; ++i) {
+    p.Feed(item.data(), item.size());
+    while (p.Next()) {
+      if (p.Type() == EntityType::TAG && p.Value() == "item") {
+        ++items;
+        REQUIRE(p.Parameters()["id"] == "1");
+      }
+    }
+    // Every complete item comes out right away.
+    REQUIRE(items == i + 1);
+  }
+  p.Feed("</root>", 7);
+  p.Finish();
+  while (p.Next()) {
+  }
+  CHECK(items == 10000);
+}
+
+namespace {
+vector<Event>
+Unbatch(const EventBatch& aBatch)
+{
+  vector<Event> events;
+  for (size_t i = 0; i < aBatch.size(); ++i) {
+    string params;
+    for (auto j = aBatch.AttributeOffsets()[i];
+         j < aBatch.AttributeOffsets()[i + 1];
+         ++j) {
+      auto& param = aBatch.Attributes()[j];
+      params += string(param.first) + "=" + string(param.second) + ";";
+    }
+    events.push_back({aBatch.Types()[i], string(aBatch.Values()[i]), params});
+  }
+  return events;
+}
+}
+
+TEST_CASE("Depth", "[xmlpp][parser][tags]")
+{
+  Parser         p("<a>x<b/><c><!--y--></c></a>");
+  vector<size_t> depths;
+  do {
+    depths.push_back(p.Depth());
+  } while (p.Next());
+  CHECK(depths == vector<size_t>({0, 1, 1, 1, 1, 2, 1, 0}));
+}
+
+TEST_CASE("Event batches", "[xmlpp][parser][batch]")
+{
+  const string document =
+    "<root attr='a&amp;b' other=\"x\"><!-- a comment --><branch/>"
+    "Some &lt;text&gt; more<leaf key='value' k2='v2'>leaf text</leaf>"
+    "</root>";
+  Parser        whole(document.c_str());
+  vector<Event> expected = Collect(whole);
+  expected.erase(expected.begin());
+  for (size_t capacity = 1; capacity <= expected.size() + 1; ++capacity) {
+    INFO("Capacity: " << capacity);
+    Parser        p(document.c_str());
+    EventBatch    batch(capacity);
+    vector<Event> events;
+    while (p.NextBatch(batch)) {
+      REQUIRE(batch.size() <= capacity);
+      auto unbatched = Unbatch(batch);
+      events.insert(events.end(), unbatched.begin(), unbatched.end());
+    }
+    CHECK(batch.empty());
+    REQUIRE(events == expected);
+  }
+
+  Parser     p("<root><a>x</a><b/></root>");
+  EventBatch batch;
+  REQUIRE(p.NextBatch(batch));
+  CHECK(batch.Names() ==
+        vector<string_view>({"a", "", "a", "b", "b", "root"}));
+  CHECK(batch.Depths() == vector<uint32_t>({1, 2, 1, 1, 1, 0}));
+  CHECK(batch.Types()[1] == EntityType::TEXT);
+  CHECK_FALSE(p.NextBatch(batch));
+}
+
+TEST_CASE("Event batches over streamed input", "[xmlpp][parser][batch]")
+{
+  const string document =
+    "<root attr='a&amp;b'>" + string(5000, 't') +
+    "<leaf key='value'>leaf text</leaf><!--c--></root>";
+  Parser        whole(document.c_str());
+  vector<Event> expected = Collect(whole);
+  ChunkLoader loader(document, 3);
+  Parser      p(ref(loader));
+  vector<Event> events = {{p.Type(), p.Value(), "attr=a&b;"}};
+  EventBatch    batch(4);
+  while (p.NextBatch(batch)) {
+    auto unbatched = Unbatch(batch);
+    events.insert(events.end(), unbatched.begin(), unbatched.end());
+  }
+  REQUIRE(events == expected);
+}
+
+TEST_CASE("Skip element", "[xmlpp][parser][skip]")
+{
+  const string document =
+    "<root><skip a='x/y' b=\"<\"><inner>&bogus; text</inner><x/>"
+    "<!-- </skip> <a> --><![CDATA[</skip><b>]]><skip><skip/></skip>"
+    "</skip><next id='1'/>tail</root>";
+  Parser p(document.c_str());
+  REQUIRE(p.Next());
+  REQUIRE(p.Value() == "skip");
+  REQUIRE(p.SkipElement());
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  CHECK(p.Value() == "skip");
+  CHECK(p.Depth() == 1);
+  REQUIRE(p.Next());
+  CHECK(p.Value() == "next");
+  // A single tag skips to its own ending.
+  REQUIRE(p.SkipElement());
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  CHECK(p.Value() == "next");
+  // Other entities just move on.
+  REQUIRE(p.Next());
+  CHECK(p.Value() == "tail");
+  REQUIRE(p.SkipElement());
+  CHECK(p.Type() == EntityType::TAG_ENDING);
+  CHECK(p.Value() == "root");
+  CHECK_FALSE(p.Next());
+
+  Parser whole(document.c_str());
+  REQUIRE(whole.SkipElement());
+  CHECK(whole.Value() == "root");
+  CHECK_FALSE(whole.Next());
+}
+
+TEST_CASE("Skip element errors", "[xmlpp][parser][skip][error]")
+{
+  auto skip = [](const char* aDocument) {
+    Parser p(aDocument);
+    p.SkipElement();
+    return p.Value();
+  };
+  CHECK_THROWS_AS(skip("<a><b></b></c>"), ParserError);
+  CHECK_THROWS_AS(skip("<a><b></c></b>"), ParserError);
+  CHECK_THROWS_AS(skip("<a><!-- unclosed </a>"), ParserError);
+  CHECK_THROWS_AS(skip("<a><?pi?></a>"), ParserError);
+  CHECK_THROWS_AS(skip("<a><!DOCTYPE></a>"), ParserError);
+  CHECK_THROWS_AS(Parser(string("<a>\0</a>", 8).c_str(), 8).SkipElement(),
+                  ParserError);
+  // Inner names are not checked, and unclosed documents just end.
+  CHECK(skip("<a><b></c></a>") == "a");
+  CHECK(skip("<a><b>") == "a");
+}
+
+TEST_CASE("Skip element over chunks", "[xmlpp][parser][skip]")
+{
+  const string document =
+    "<root><skip a='1'><!-- > --><x>t&amp;</x><![CDATA[<y>]]><z/></skip>"
+    "<after/></root>";
+  for (size_t size = 1; size <= document.size(); ++size) {
+    INFO("Chunk size: " << size);
+    ChunkLoader loader(document, size);
+    Parser      p(ref(loader));
+    REQUIRE(p.Next());
+    REQUIRE(p.SkipElement());
+    REQUIRE(p.Value() == "skip");
+    REQUIRE(p.Next());
+    REQUIRE(p.Value() == "after");
+
+    // In push mode Next() goes on with a skip that ran out of input.
+    Parser         pushed;
+    vector<string> events;
+    auto           record = [&]() {
+      events.push_back(to_string(int(pushed.Type())) + pushed.Value());
+    };
+    for (size_t i = 0; i < document.size(); i += size) {
+      pushed.Feed(document.data() + i, min(size, document.size() - i));
+      while (pushed.Next()) {
+        record();
+        if (pushed.Type() == EntityType::TAG && pushed.Value() == "skip" &&
+            pushed.SkipElement()) {
+          record();
+        }
+      }
+    }
+    REQUIRE(events ==
+            vector<string>({"0root", "0skip", "1skip", "0after", "1after",
+                            "1root"}));
+
+    // Or with SkipElement(), called again after each Feed().
+    Parser         resumed;
+    vector<string> resumed_events;
+    bool           skipping = false;
+    for (size_t i = 0; i < document.size(); i += size) {
+      resumed.Feed(document.data() + i, min(size, document.size() - i));
+      while (skipping ? resumed.SkipElement() : resumed.Next()) {
+        resumed_events.push_back(to_string(int(resumed.Type())) +
+                                 resumed.Value());
+        skipping =
+          resumed.Type() == EntityType::TAG && resumed.Value() == "skip";
+      }
+    }
+    REQUIRE(resumed_events == events);
+  }
+}
+
+TEST_CASE("Event masks", "[xmlpp][parser][mask]")
+{
+  const char* document =
+    "<root><!-- a comment -->text &amp; <![CDATA[<more>]]><x/>\n"
+    "<!----><y a='1'>tail</y>  </root>";
+  auto events = [&](EventMask aEvents) {
+    vector<string> result;
+    Parser         p(document, aEvents);
+    do {
+      result.push_back(to_string(int(p.Type())) + p.Value());
+    } while (p.Next());
+    return result;
+  };
+  REQUIRE(events(EventMask::ALL) ==
+          vector<string>({"0root", "2 a comment ", "3text & <more>", "0x",
+                          "1x", "2", "0y", "3tail", "1y", "1root"}));
+  REQUIRE(events(EventMask::TEXTS) ==
+          vector<string>({"0root", "3text & <more>", "0x", "1x", "0y",
+                          "3tail", "1y", "1root"}));
+  REQUIRE(events(EventMask::COMMENTS) ==
+          vector<string>(
+            {"0root", "2 a comment ", "0x", "1x", "2", "0y", "1y", "1root"}));
+  REQUIRE(events(EventMask::NONE) ==
+          vector<string>({"0root", "0x", "1x", "0y", "1y", "1root"}));
+  REQUIRE(events(~EventMask::COMMENTS) == events(EventMask::TEXTS));
+
+  Parser p("<!-- first --> top <a>&amp;</a> end ", EventMask::NONE);
+  REQUIRE(p.Type() == EntityType::TAG);
+  REQUIRE(p.Value() == "a");
+  REQUIRE(p.Parameters().empty());
+  REQUIRE(p.Next());
+  REQUIRE(p.Type() == EntityType::TAG_ENDING);
+  REQUIRE_FALSE(p.Next());
+}
+
+TEST_CASE("Event mask errors", "[xmlpp][parser][mask][error]")
+{
+  auto parse = [](const char* aCode, EventMask aEvents) {
+    Parser p(aCode, aEvents);
+    while (p.Next()) {
+    }
+  };
+  CHECK_THROWS_AS(parse("<a><!-- x </a>", EventMask::TEXTS), ParserError);
+  CHECK_THROWS_AS(parse("<a><!- x --></a>", EventMask::TEXTS), ParserError);
+  CHECK_THROWS_AS(parse("<a><![CDATA[x</a>", EventMask::NONE), ParserError);
+  CHECK_THROWS_AS(parse("<a>x</b>", EventMask::NONE), ParserError);
+  // Masked texts are not decoded, so their escapes are not checked.
+  CHECK_NOTHROW(parse("<a>&bogus;</a>", EventMask::NONE));
+  CHECK_THROWS_AS(parse("<a>&bogus;</a>", EventMask::TEXTS), ParserError);
+
+  const char text[] = "<a>x\0</a>";
+  Parser     p(text, sizeof(text) - 1, EventMask::NONE);
+  CHECK_THROWS_AS(p.Next(), ParserError);
+}
+
+TEST_CASE("Event masks over chunks", "[xmlpp][parser][mask]")
+{
+  const string document =
+    "<root><!-- c --> t&amp; <![CDATA[x]]><a/><!-- d -->u</root>  ";
+  for (size_t size = 1; size <= document.size(); ++size) {
+    INFO("Chunk size: " << size);
+    ChunkLoader    loader(document, size);
+    vector<string> loaded;
+    Parser         p(ref(loader), EventMask::NONE);
+    do {
+      loaded.push_back(to_string(int(p.Type())) + p.Value());
+    } while (p.Next());
+    REQUIRE(loaded == vector<string>({"0root", "0a", "1a", "1root"}));
+
+    Parser         pushed(EventMask::COMMENTS);
+    vector<string> events;
+    for (size_t i = 0; i < document.size(); i += size) {
+      pushed.Feed(document.data() + i, min(size, document.size() - i));
+      while (pushed.Next()) {
+        events.push_back(to_string(int(pushed.Type())) + pushed.Value());
+      }
+    }
+    pushed.Finish();
+    while (pushed.Next()) {
+      events.push_back(to_string(int(pushed.Type())) + pushed.Value());
+    }
+    REQUIRE(events == vector<string>({"0root", "2 c ", "0a", "1a", "2 d ",
+                                      "1root"}));
+  }
+}
@@ -0,0 +1,137 @@
+#include "PathQuery.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+namespace {
+const char* DOCUMENT = "<library><!--c-->"
+                       "<book lang='en' id='1'><title>One &amp; two</title>"
+                       "<author>A</author></book>"
+                       "<book lang='fr' id='2'><title>Deux</title></book>"
+                       "<shelf><book lang='en' id='3'><title>Three</title>"
+                       "<book id='4'><title>Four</title></book></book></shelf>"
+                       "<book id='5'/>"
+                       "</library>";
+
+// Each match, as its tag's id, or its text.
+vector<string>
+Matches(const char* aPath, const char* aCode = DOCUMENT)
+{
+  PathQuery      query(aPath);
+  Parser         p(aCode);
+  vector<string> result;
+  while (query.Next(p)) {
+    if (p.Type() == EntityType::TAG) {
+      result.emplace_back(p.Parameters()["id"]);
+    } else {
+      result.push_back(p.Value());
+    }
+  }
+  return result;
+}
+}
+
+TEST_CASE("Path steps", "[xmlpp][path]")
+{
+  CHECK(Matches("/library/book") == vector<string>({"1", "2", "5"}));
+  CHECK(Matches("/library/shelf/book") == vector<string>({"3"}));
+  CHECK(Matches("/library/*/book") == vector<string>({"3"}));
+  CHECK(Matches("/book").empty());
+  CHECK(Matches("/library/nothing").empty());
+  CHECK(Matches("//book") == vector<string>({"1", "2", "3", "4", "5"}));
+  CHECK(Matches("//book/book") == vector<string>({"4"}));
+  CHECK(Matches("/library//book/title/text()") ==
+        vector<string>({"One & two", "Deux", "Three", "Four"}));
+  CHECK(Matches("//author/text()") == vector<string>({"A"}));
+  CHECK(Matches("/library/book/text()").empty());
+  CHECK(Matches("//text()") ==
+        vector<string>({"One & two", "A", "Deux", "Three", "Four"}));
+}
+
+TEST_CASE("Path predicates", "[xmlpp][path]")
+{
+  CHECK(Matches("//book[@lang='en']") == vector<string>({"1", "3"}));
+  CHECK(Matches("//book[@lang=\"fr\"]/title/text()") ==
+        vector<string>({"Deux"}));
+  CHECK(Matches("//book[@lang]") == vector<string>({"1", "2", "3"}));
+  CHECK(Matches("//book[@lang='de']").empty());
+  CHECK(Matches("/library/book[2]") == vector<string>({"2"}));
+  CHECK(Matches("/library/book[4]").empty());
+  CHECK(Matches("/library/*[3]/book") == vector<string>({"3"}));
+  CHECK(Matches("//book[1]") == vector<string>({"1", "3", "4"}));
+  // Positions count the siblings that passed the predicates before.
+  CHECK(Matches("/library/book[@lang][2]") == vector<string>({"2"}));
+  CHECK(Matches("/library/book[2][@lang='en']").empty());
+  CHECK(Matches("/library/book[@id='5'][1]") == vector<string>({"5"}));
+}
+
+TEST_CASE("Path skipping", "[xmlpp][path]")
+{
+  // Subtrees that can not match are skipped without being decoded.
+  const char* code = "<r><x>&bogus;<y>no</y></x><y>yes</y></r>";
+  CHECK(Matches("/r/y/text()", code) == vector<string>({"yes"}));
+  CHECK_THROWS_AS(Matches("//y/text()", code), ParserError);
+
+  // Reading a match does not disturb the query.
+  PathQuery query("/r/*");
+  Parser    p(code);
+  REQUIRE(query.Next(p));
+  CHECK(p.Value() == "x");
+  REQUIRE(query.Next(p));
+  CHECK(p.Value() == "y");
+  CHECK_FALSE(query.Next(p));
+
+  query.Reset();
+  Parser other("<r><z/></r>");
+  REQUIRE(query.Next(other));
+  CHECK(other.Value() == "z");
+  CHECK_FALSE(query.Next(other));
+}
+
+TEST_CASE("Path over pushed input", "[xmlpp][path]")
+{
+  const string document = DOCUMENT;
+  for (size_t size = 1; size <= document.size(); size += 7) {
+    INFO("Chunk size: " << size);
+    PathQuery      query("//book[@lang='en']/title/text()");
+    Parser         p;
+    vector<string> titles;
+    for (size_t i = 0; i < document.size(); i += size) {
+      p.Feed(document.data() + i, min(size, document.size() - i));
+      while (query.Next(p)) {
+        titles.push_back(p.Value());
+      }
+    }
+    p.Finish();
+    while (query.Next(p)) {
+      titles.push_back(p.Value());
+    }
+    CHECK(titles == vector<string>({"One & two", "Three"}));
+  }
+}
+
+TEST_CASE("Invalid paths", "[xmlpp][path][error]")
+{
+  CHECK_THROWS_AS(PathQuery(""), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("book"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/a/"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("///a"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/a[@b='c]"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/a[@b=c]"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/a[0]"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/a[x]"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/a[1"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/text()/a"), invalid_argument);
+  CHECK_THROWS_AS(PathQuery("/a b"), invalid_argument);
+  string deep;
+  for (int i = 0; i < 65; ++i) {
+    deep += "/a";
+  }
+  CHECK_THROWS_AS(PathQuery(deep), invalid_argument);
+  CHECK_NOTHROW(PathQuery(deep.substr(2)));
+}
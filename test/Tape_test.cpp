@@ -0,0 +1,91 @@
+#include "Tape.hpp"
+#include <string>
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+TEST_CASE("Tape entries", "[xmlpp][tape]")
+{
+  const string document = "<root a='1' b='x&amp;y'><leaf/>some &lt;text"
+                          "<!--c--><branch><x>y</x></branch></root>";
+  Tape         tape(document.data(), document.size());
+  REQUIRE(tape.size() == 15);
+  const Tape::EntryType types[] = {
+    Tape::TAG,        Tape::PARAM_NAME, Tape::PARAM_VALUE,
+    Tape::PARAM_NAME, Tape::PARAM_VALUE, Tape::TAG,
+    Tape::TAG_ENDING, Tape::TEXT,       Tape::COMMENT,
+    Tape::TAG,        Tape::TAG,        Tape::TEXT,
+    Tape::TAG_ENDING, Tape::TAG_ENDING, Tape::TAG_ENDING,
+  };
+  for (size_t i = 0; i < 15; ++i) {
+    INFO("Entry " << i);
+    CHECK(tape.Type(i) == types[i]);
+  }
+  CHECK(tape.View(0) == "root");
+  CHECK(tape.View(1) == "a");
+  CHECK(tape.View(2) == "1");
+  CHECK(tape.View(4) == "x&y");
+  CHECK(tape.Decoded(4));
+  CHECK_FALSE(tape.Decoded(2));
+  CHECK(tape.View(5) == "leaf");
+  CHECK(tape.View(7) == "some <text");
+  CHECK(tape.View(8) == "c");
+  CHECK(tape.View(9) == "branch");
+  CHECK(tape.View(11) == "y");
+
+  CHECK(tape.Ending(0) == 14);
+  CHECK(tape.Ending(5) == 6);
+  CHECK(tape.Ending(9) == 13);
+  CHECK(tape.Skip(9) == 14);
+  CHECK(tape.Skip(1) == 3);
+  CHECK(tape.Skip(7) == 8);
+
+  // Offsets point back into the source, decoded values included.
+  CHECK(document.substr(tape.Offset(9), 6) == "branch");
+  CHECK(document.compare(tape.Offset(14), 4, "root") == 0);
+  CHECK(tape.RawView(4) == "x&amp;y");
+  CHECK(document.compare(tape.Offset(4), 7, "x&amp;y") == 0);
+  CHECK(tape.RawView(7) == "some &lt;text");
+  CHECK(tape.RawView(2) == "1");
+  CHECK(tape.RawView(0) == "root");
+}
+
+TEST_CASE("Tape decoded values", "[xmlpp][tape]")
+{
+  const string document = "<r a=\"&lt;'\" b='&#65;'>&amp;<![CDATA[<x>]]>"
+                          "<s/>plain&gt;</r>";
+  Tape         tape(document.data(), document.size());
+  REQUIRE(tape.size() == 10);
+  CHECK(tape.View(2) == "<'");
+  CHECK(tape.RawView(2) == "&lt;'");
+  CHECK(tape.View(4) == "A");
+  CHECK(tape.RawView(4) == "&#65;");
+  CHECK(tape.View(5) == "&<x>");
+  CHECK(tape.RawView(5) == "&amp;<![CDATA[<x>]]>");
+  CHECK_FALSE(tape.Decoded(6));
+  CHECK(tape.View(8) == "plain>");
+  CHECK(tape.RawView(8) == "plain&gt;");
+  CHECK(tape.View(9) == "r");
+}
+
+TEST_CASE("Tape walks", "[xmlpp][tape]")
+{
+  string document = "<list>";
+  for (int i = 0; i < 100; ++i) {
+    document += "<item id='" + to_string(i) + "'><a>x</a><b/></item>";
+  }
+  document += "</list>";
+  Tape   tape(document.c_str());
+  size_t items = 0;
+  for (size_t i = 1; tape.Type(i) != Tape::TAG_ENDING; i = tape.Skip(i)) {
+    REQUIRE(tape.Type(i) == Tape::TAG);
+    REQUIRE(tape.View(i) == "item");
+    REQUIRE(tape.View(i + 2) == to_string(items));
+    ++items;
+  }
+  CHECK(items == 100);
+  CHECK(Tape("").empty());
+  CHECK_THROWS_AS(Tape("<root>"), ParserError);
+  CHECK_THROWS_AS(Tape("<root></toor>"), ParserError);
+}
@@ -0,0 +1,32 @@
+#include "charClass.hpp"
+#include "catch.hpp"
+
+using namespace xmlpp;
+
+TEST_CASE("Char classes", "[xmlpp][charclass]")
+{
+  static_assert(IsBlank(' ') && IsBlank('\t') && IsBlank('\n') &&
+                  IsBlank('\r'),
+                "Blanks");
+  static_assert(!IsBlank('\0') && !IsBlank('a'), "Not blanks");
+  CHECK(IsNameStart('a'));
+  CHECK(IsNameStart('Z'));
+  CHECK(IsNameStart('_'));
+  CHECK(IsNameStart(':'));
+  CHECK(IsNameStart("á"[0]));
+  CHECK_FALSE(IsNameStart('1'));
+  CHECK_FALSE(IsNameStart('-'));
+  CHECK(IsNameChar('1'));
+  CHECK(IsNameChar('-'));
+  CHECK(IsNameChar('.'));
+  CHECK_FALSE(IsNameChar('\0'));
+  CHECK_FALSE(IsNameChar('>'));
+  CHECK_FALSE(IsNameChar(' '));
+  CHECK(IsQuote('"'));
+  CHECK(IsQuote('\''));
+  CHECK_FALSE(IsQuote('`'));
+  for (char c : "<>/=?&") {
+    CHECK((c == 0 || IsMarkup(c)));
+  }
+  CHECK_FALSE(IsMarkup('a'));
+}
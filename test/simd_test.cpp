@@ -0,0 +1,67 @@
+#include "simd.hpp"
+#include <memory>
+#include <string>
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+namespace {
+// Runs each kernel this CPU has directly, not only the selected one.
+void
+CheckKernels(const char* aBegin, const char* aEnd, char aFirst, char aSecond)
+{
+  auto expected = simd::ScanUntilScalar(aBegin, aEnd, aFirst, aSecond);
+  REQUIRE(ScanUntil(aBegin, aEnd, aFirst, aSecond) == expected);
+#ifdef XMLPP_SSE2
+  REQUIRE(simd::ScanUntilSse2(aBegin, aEnd, aFirst, aSecond) == expected);
+#endif
+#ifdef XMLPP_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    REQUIRE(simd::ScanUntilAvx2(aBegin, aEnd, aFirst, aSecond) == expected);
+  }
+#endif
+}
+}
+
+TEST_CASE("ScanUntil", "[xmlpp][simd]")
+{
+  // Every start alignment and every match position within a few blocks.
+  for (size_t start = 0; start < 32; ++start) {
+    for (size_t match = start; match < 100; ++match) {
+      string text(128, 'x');
+      text[match] = (match % 3) ? ((match % 3 == 1) ? '<' : '&') : '\0';
+      auto beg    = text.data() + start;
+      auto end    = text.data() + text.size();
+      auto found  = text.data() + match;
+      REQUIRE(simd::ScanUntilScalar(beg, end, '<', '&') == found);
+      CheckKernels(beg, end, '<', '&');
+    }
+  }
+  SECTION("Stops at the end")
+  {
+    string text(100, 'x');
+    text[77] = '<';
+    for (size_t start = 0; start < 40; ++start) {
+      for (size_t end = start; end <= 77; ++end) {
+        REQUIRE(simd::ScanUntilScalar(
+                  text.data() + start, text.data() + end, '<', '&') ==
+                text.data() + end);
+        CheckKernels(text.data() + start, text.data() + end, '<', '&');
+      }
+    }
+  }
+  SECTION("Same char twice")
+  {
+    string text = string(40, 'x') + "&<";
+    REQUIRE(simd::ScanUntilScalar(
+              text.data(), text.data() + text.size(), '<', '<') ==
+            text.data() + 41);
+    CheckKernels(text.data(), text.data() + text.size(), '<', '<');
+  }
+  SECTION("Empty range")
+  {
+    CheckKernels(nullptr, nullptr, '<', '&');
+    REQUIRE(ScanUntil(nullptr, nullptr, '<', '&') == nullptr);
+  }
+}
@@ -0,0 +1,34 @@
+#include "utf8.hpp"
+#include <string>
+#include "catch.hpp"
+
+using namespace xmlpp;
+using namespace std;
+
+static string
+Encode(char32_t aCodePoint)
+{
+  char buffer[UTF8_MAX_BYTES];
+  return string(buffer, EncodeUtf8(aCodePoint, buffer));
+}
+
+TEST_CASE("EncodeUtf8", "[xmlpp][utf8]")
+{
+  CHECK(Encode(U'A') == "A");
+  CHECK(Encode(0x7F) == "\x7F");
+  CHECK(Encode(0x80) == "\xC2\x80");
+  CHECK(Encode(U'ö') == "ö");
+  CHECK(Encode(0x7FF) == "\xDF\xBF");
+  CHECK(Encode(0x800) == "\xE0\xA0\x80");
+  CHECK(Encode(U'€') == "€");
+  CHECK(Encode(0xFFFF) == "\xEF\xBF\xBF");
+  CHECK(Encode(0x10000) == "\xF0\x90\x80\x80");
+  CHECK(Encode(U'😀') == "😀");
+  CHECK(Encode(0x10FFFF) == "\xF4\x8F\xBF\xBF");
+  SECTION("Invalid code points")
+  {
+    CHECK(Encode(0xD800) == "");
+    CHECK(Encode(0xDFFF) == "");
+    CHECK(Encode(0x110000) == "");
+  }
+}